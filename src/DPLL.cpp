@@ -1,122 +1,123 @@
-#include <algorithm>
-#include <cmath>
+#include <cinttypes>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
-#include <tuple>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "cnf/dimacs.h"
+#include "heuristics.h"
+#include "search.h"
 #include "unit_propagation.h"
 
-std::pair<bool, std::vector<std::vector<int>>> unit_propagation(const std::vector<std::vector<int>> &clauses, std::size_t numvar)
+void simplify(std::shared_ptr<const ClauseStore> store, bool pure_literals)
 {
-	return UnitPropagator(clauses, numvar).propagate();
-}
-
-bool solve_sat(std::size_t numvar, std::vector<std::vector<int>> &clauses, std::vector<int> &assignments)
-{
-	if(numvar == assignments.size())
-		return true;
+	std::size_t numvar = store->numvar;
+	UnitPropagator propagator(store);
+	ResidualFormula residual;
 
-	assignments.emplace_back(1);
-	clauses.emplace_back(std::initializer_list<int>{static_cast<int>(assignments.size())});
+	if(pure_literals)
+		propagator.enable_pure_literals();
 
-	bool possible;
-	std::vector<std::vector<int>> up_clauses;
-
-	std::tie(possible, up_clauses) = unit_propagation(clauses, numvar);
-
-	if(possible && solve_sat(numvar, up_clauses, assignments))
-		return true;
+	if(!propagator.propagate())
+	{
+		std::printf("p cnf %zu 1\n0\n", numvar);
+		return;
+	}
 
-	assignments.back() = -1;
-	clauses.back().front() = -static_cast<int>(assignments.size());
+	propagator.produce_output(residual);
+	std::printf("p cnf %zu %zu\n", numvar, residual.units.size() + residual.size());
 
-	std::tie(possible, up_clauses) = unit_propagation(clauses, numvar);
+	for(int literal : residual.units)
+		std::printf("%d 0\n", literal);
 
-	if(possible && solve_sat(numvar, up_clauses, assignments))
-		return true;
+	for(std::size_t c = 0; c < residual.size(); ++c)
+	{
+		for(std::uint32_t i = residual.offsets[c]; i < residual.offsets[c + 1]; ++i)
+			std::printf("%d ", residual.literals[i]);
 
-	assignments.pop_back();
-	return false;
+		std::printf("0\n");
+	}
 }
 
-void solve(std::size_t numvar, std::vector<std::vector<int>> &clauses)
+void solve(std::shared_ptr<const ClauseStore> store, const SearchOptions &options)
 {
-	std::vector<int> assignments;
-	bool possible;
-	std::vector<std::vector<int>> up_clauses;
+	std::size_t numvar = store->numvar;
+	std::vector<std::uint8_t> model;
+	SearchStats stats;
+	bool satisfiable = solve_formula(store, options, model, stats);
 
-	std::tie(possible, up_clauses) = unit_propagation(clauses, numvar);
+	std::printf("c %" PRIu64 " decisions, %" PRIu64 " conflicts, %" PRIu64 " propagations\n", stats.decisions, stats.conflicts, stats.propagations);
 
-	if(possible && solve_sat(numvar, up_clauses, assignments))
+	if(satisfiable)
 	{
 		std::printf("s SATISFIABLE\n");
 
-		for(std::size_t i = 0; i < numvar; ++i)
+		for(std::size_t i = 1; i <= numvar; ++i)
 		{
 			std::printf("v ");
 
-			if(std::signbit(assignments[i]))
+			if(!model[i])
 				std::printf("-");
 
-			std::printf("%zu\n", i + 1);
+			std::printf("%zu\n", i);
 		}
 	}
 	else
 		std::printf("s UNSATISFIABLE\n");
 }
 
-int main()
+int main(int argc, char **argv)
 {
-	char line[1024], format[256];
-	std::size_t numvar, numclause;
-	std::vector<std::vector<int>> clauses;
+	bool simplify_only = false;
+	const char *path = nullptr;
+	SearchOptions options;
 
-	while(true)
+	for(int i = 1; i < argc; ++i)
 	{
-		if(std::fgets(line, sizeof(line), stdin) == nullptr)
-			break;
-
-		if(line[0] != 'p')
-			continue;
-
-		if(std::sscanf(line, "p %s%zu%zu", format, &numvar, &numclause) != 3)
-		{
-			std::printf("Bad input line: %s\n", line);
-			return -1;
-		}
-
-		if(std::strcmp(format, "cnf") != 0)
+		if(std::strcmp(argv[i], "-s") == 0)
+			simplify_only = true;
+		else if(std::strcmp(argv[i], "-p") == 0)
+			options.pure_literals = true;
+		else if(std::strcmp(argv[i], "-b") == 0 && i + 1 < argc && make_heuristic(argv[i + 1]))
+			options.heuristic = argv[++i];
+		else if(std::strcmp(argv[i], "-c") == 0)
+			options.learning = true;
+		else if(std::strcmp(argv[i], "-j") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+			options.threads = static_cast<std::size_t>(std::atoi(argv[++i]));
+		else if(path == nullptr && (argv[i][0] != '-' || std::strcmp(argv[i], "-") == 0))
+			path = argv[i];
+		else
 		{
-			std::printf("Bad format: %s\n", format);
+			std::printf("Usage: %s [-s] [-p] [-b order|dlis|moms|jw] [-j N] [-c] [input.cnf]\n", argv[0]);
+			std::printf("  reads DIMACS CNF from input.cnf, or from stdin when it is missing or -\n");
+			std::printf("  -s  print the formula left after unit propagation instead of solving\n");
+			std::printf("  -p  also assign pure literals during propagation\n");
+			std::printf("  -b  branching heuristic (default: order)\n");
+			std::printf("  -j  number of work-stealing search threads (default: 1)\n");
+			std::printf("  -c  conflict-driven clause learning with VSIDS instead of DPLL (-p, -b and -j do not apply)\n");
 			return -1;
 		}
+	}
 
-		for(std::size_t i = 0; i < numclause; ++i)
-		{
-			std::vector<int> clause;
-
-			while(true)
-			{
-				int var;
-
-				if(std::scanf("%d", &var) != 1)
-				{
-					std::printf("Bad input\n");
-					return -1;
-				}
+	DimacsFormula formula;
+	std::string error;
 
-				if(var == 0)
-					break;
+	if(!read_dimacs(path, formula, error))
+	{
+		std::printf("%s\n", error.c_str());
+		return -1;
+	}
 
-				clause.emplace_back(var);
-			}
+	std::shared_ptr<const ClauseStore> store = std::make_shared<const ClauseStore>(std::move(formula.literals), std::move(formula.offsets), formula.numvar);
 
-			clauses.emplace_back(std::move(clause));
-		}
-	}
+	if(simplify_only)
+		simplify(store, options.pure_literals);
+	else
+		solve(store, options);
 
-	solve(numvar, clauses);
 	return 0;
 }
@@ -0,0 +1,310 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "bit_propagation.h"
+
+template<std::size_t Words>
+LaneMask<Words> LaneMask<Words>::none()
+{
+	LaneMask<Words> result;
+	for (std::size_t i = 0; i < Words; ++i)
+		result.word[i] = 0;
+	return result;
+}
+
+template<std::size_t Words>
+LaneMask<Words> LaneMask<Words>::all()
+{
+	return ~none();
+}
+
+template<std::size_t Words>
+LaneMask<Words> LaneMask<Words>::lane(std::size_t lane)
+{
+	LaneMask<Words> result = none();
+	result.word[lane / 64] = std::uint64_t(1) << (lane % 64);
+	return result;
+}
+
+template<std::size_t Words>
+LaneMask<Words> LaneMask<Words>::operator&(const LaneMask<Words> &other) const
+{
+	LaneMask<Words> result;
+	for (std::size_t i = 0; i < Words; ++i)
+		result.word[i] = word[i] & other.word[i];
+	return result;
+}
+
+template<std::size_t Words>
+LaneMask<Words> LaneMask<Words>::operator|(const LaneMask<Words> &other) const
+{
+	LaneMask<Words> result;
+	for (std::size_t i = 0; i < Words; ++i)
+		result.word[i] = word[i] | other.word[i];
+	return result;
+}
+
+template<std::size_t Words>
+LaneMask<Words> LaneMask<Words>::operator~() const
+{
+	LaneMask<Words> result;
+	for (std::size_t i = 0; i < Words; ++i)
+		result.word[i] = ~word[i];
+	return result;
+}
+
+template<std::size_t Words>
+bool LaneMask<Words>::any() const
+{
+	std::uint64_t bits = 0;
+	for (std::size_t i = 0; i < Words; ++i)
+		bits |= word[i];
+	return bits != 0;
+}
+
+#ifdef __AVX2__
+// 256 lanes fit one AVX2 register.
+
+static inline __m256i load(const LaneMask<4> &mask) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask.word)); }
+static inline LaneMask<4> store(__m256i value)
+{
+	LaneMask<4> result;
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(result.word), value);
+	return result;
+}
+
+template<>
+LaneMask<4> LaneMask<4>::operator&(const LaneMask<4> &other) const { return store(_mm256_and_si256(load(*this), load(other))); }
+
+template<>
+LaneMask<4> LaneMask<4>::operator|(const LaneMask<4> &other) const { return store(_mm256_or_si256(load(*this), load(other))); }
+
+template<>
+LaneMask<4> LaneMask<4>::operator~() const { return store(_mm256_xor_si256(load(*this), _mm256_set1_epi64x(-1))); }
+
+template<>
+bool LaneMask<4>::any() const
+{
+	__m256i value = load(*this);
+	return !_mm256_testz_si256(value, value);
+}
+#endif
+
+/**
+ * Propagation runs off a queue of clauses: a clause is (re)queued whenever one of its literals becomes
+ * false in some lane. Per clause, with T and F the lanes where a literal is true and false, the lanes
+ * where every literal but l is false and l is unassigned make l true, and the lanes where every literal
+ * is false conflict. Prefix and suffix ANDs of F give all of these in O(clause length) mask operations.
+ */
+
+template<std::size_t Words>
+BitPropagator<Words>::BitPropagator(std::shared_ptr<const ClauseStore> store)
+	: _store(store)
+{
+	reset();
+}
+
+template<std::size_t Words>
+void BitPropagator<Words>::reset()
+{
+	_true.assign(_store->numvar + 1, Mask::none());
+	_false.assign(_store->numvar + 1, Mask::none());
+	_conflict = Mask::none();
+	_queued.assign(_store->size(), 1);
+	_queue.resize(_store->size());
+	for (std::uint32_t clause_id = 0; clause_id < _store->size(); ++clause_id)
+		_queue[clause_id] = clause_id;
+	_is_changed.assign(_store->numvar + 1, 0);
+	checkpoint();
+}
+
+template<std::size_t Words>
+void BitPropagator<Words>::checkpoint()
+{
+	for (std::uint32_t variable : _changed)
+		_is_changed[variable] = 0;
+	_changed.clear();
+	_saved_true.clear();
+	_saved_false.clear();
+	_saved_conflict = _conflict;
+}
+
+template<std::size_t Words>
+void BitPropagator<Words>::rollback()
+{
+	for (std::size_t i = 0; i < _changed.size(); ++i)
+	{
+		_true[_changed[i]] = _saved_true[i];
+		_false[_changed[i]] = _saved_false[i];
+	}
+	_conflict = _saved_conflict;
+
+	for (std::uint32_t clause_id : _queue)
+		_queued[clause_id] = 0;
+	_queue.clear();
+	checkpoint();
+}
+
+template<std::size_t Words>
+void BitPropagator<Words>::set_true(int literal, const Mask &lanes)
+{
+	std::size_t variable = static_cast<std::size_t>(literal > 0 ? literal : -literal);
+	Mask &own = literal > 0 ? _true[variable] : _false[variable];
+	const Mask &other = literal > 0 ? _false[variable] : _true[variable];
+
+	if (!_is_changed[variable])
+	{
+		_is_changed[variable] = 1;
+		_changed.push_back(static_cast<std::uint32_t>(variable));
+		_saved_true.push_back(_true[variable]);
+		_saved_false.push_back(_false[variable]);
+	}
+
+	_conflict = _conflict | (lanes & other);
+	own = own | lanes;
+
+	std::size_t lit = literal_index(-literal);
+	for (std::uint32_t j = _store->occurrence_start[lit]; j < _store->occurrence_start[lit + 1]; ++j)
+	{
+		std::uint32_t clause_id = _store->occurrences[j];
+		if (!_queued[clause_id])
+		{
+			_queued[clause_id] = 1;
+			_queue.push_back(clause_id);
+		}
+	}
+}
+
+template<std::size_t Words>
+void BitPropagator<Words>::assign(int literal, std::size_t lane)
+{
+	set_true(literal, Mask::lane(lane));
+}
+
+template<std::size_t Words>
+void BitPropagator<Words>::propagate_clause(std::uint32_t clause_id)
+{
+	const int *literals = _store->literals.data() + _store->offsets[clause_id];
+	std::size_t size = _store->offsets[clause_id + 1] - _store->offsets[clause_id];
+	// suffix[i] holds the lanes where literals i.. are all false
+	std::vector<Mask> &suffix = _suffix;
+
+	suffix.resize(size + 1);
+	suffix[size] = Mask::all();
+	for (std::size_t i = size; i-- > 0;)
+	{
+		std::size_t variable = static_cast<std::size_t>(literals[i] > 0 ? literals[i] : -literals[i]);
+		suffix[i] = suffix[i + 1] & (literals[i] > 0 ? _false[variable] : _true[variable]);
+	}
+
+	_conflict = _conflict | suffix[0];
+
+	Mask prefix = Mask::all();
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		std::size_t variable = static_cast<std::size_t>(literals[i] > 0 ? literals[i] : -literals[i]);
+		Mask unit = prefix & suffix[i + 1] & ~(_true[variable] | _false[variable]);
+
+		if (unit.any())
+			set_true(literals[i], unit);
+
+		prefix = prefix & (literals[i] > 0 ? _false[variable] : _true[variable]);
+	}
+}
+
+template<std::size_t Words>
+typename BitPropagator<Words>::Mask BitPropagator<Words>::propagate()
+{
+	for (std::size_t head = 0; head < _queue.size(); ++head)
+	{
+		_queued[_queue[head]] = 0;
+		propagate_clause(_queue[head]);
+	}
+
+	_queue.clear();
+	return _conflict;
+}
+
+template<std::size_t Words>
+std::vector<AssumptionResult> propagate_assumption_sets_bitparallel(std::shared_ptr<const ClauseStore> store,
+	const std::vector<std::vector<int>> &assumption_sets)
+{
+	typedef typename BitPropagator<Words>::Mask Mask;
+	const std::size_t lanes = BitPropagator<Words>::lanes;
+	std::vector<AssumptionResult> results(assumption_sets.size());
+	BitPropagator<Words> propagator(store);
+
+	// the root state is propagated once; what holds there is not reported as implied
+	if (propagator.propagate().any())
+	{
+		for (AssumptionResult &result : results)
+			result.conflict = true;
+		return results;
+	}
+	propagator.checkpoint();
+
+	for (std::size_t first = 0; first < assumption_sets.size(); first += lanes)
+	{
+		std::size_t count = assumption_sets.size() - first < lanes ? assumption_sets.size() - first : lanes;
+
+		for (std::size_t lane = 0; lane < count; ++lane)
+			for (int literal : assumption_sets[first + lane])
+				propagator.assign(literal, lane);
+
+		Mask conflict = propagator.propagate();
+
+		for (std::size_t lane = 0; lane < count; ++lane)
+			results[first + lane].conflict = conflict.test(lane);
+
+		for (std::size_t i = 0; i < propagator.changed().size(); ++i)
+		{
+			std::uint32_t variable = propagator.changed()[i];
+			const Mask &positive = propagator.true_lanes(variable);
+			Mask assigned = propagator.assigned_since_checkpoint(i) & ~conflict;
+
+			for (std::size_t w = 0; w < Words; ++w)
+				for (std::uint64_t bits = assigned.word[w]; bits != 0; bits &= bits - 1)
+				{
+					std::size_t lane = 64 * w + static_cast<std::size_t>(__builtin_ctzll(bits));
+					if (lane < count)
+						results[first + lane].implied.push_back(positive.test(lane) ? static_cast<int>(variable) : -static_cast<int>(variable));
+				}
+		}
+
+		// the assumptions themselves are not reported either
+		for (std::size_t lane = 0; lane < count; ++lane)
+		{
+			std::vector<int> &implied = results[first + lane].implied;
+			std::size_t kept = 0;
+
+			for (int literal : implied)
+			{
+				bool assumed = false;
+				for (int assumption : assumption_sets[first + lane])
+					assumed = assumed || assumption == literal;
+				if (!assumed)
+					implied[kept++] = literal;
+			}
+			implied.resize(kept);
+		}
+
+		propagator.rollback();
+	}
+
+	return results;
+}
+
+template struct LaneMask<1>;
+template struct LaneMask<4>;
+template class BitPropagator<1>;
+template class BitPropagator<4>;
+template std::vector<AssumptionResult> propagate_assumption_sets_bitparallel<1>(std::shared_ptr<const ClauseStore>,
+	const std::vector<std::vector<int>> &);
+template std::vector<AssumptionResult> propagate_assumption_sets_bitparallel<4>(std::shared_ptr<const ClauseStore>,
+	const std::vector<std::vector<int>> &);
@@ -0,0 +1,85 @@
+#ifndef _BIT_PROP
+#define _BIT_PROP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "unit_propagation.h"
+
+// One bit per lane, Words * 64 lanes in all.
+template<std::size_t Words>
+struct LaneMask {
+	std::uint64_t word[Words];
+
+	static LaneMask none();
+	static LaneMask all();
+	static LaneMask lane(std::size_t lane);
+
+	LaneMask operator&(const LaneMask &other) const;
+	LaneMask operator|(const LaneMask &other) const;
+	LaneMask operator~() const;
+	bool any() const;
+	bool test(std::size_t lane) const { return (word[lane / 64] >> (lane % 64)) & 1; }
+};
+
+/**
+ * Bit-parallel unit propagation: every variable holds a mask of the lanes where it is true and a mask
+ * of the lanes where it is false, so one pass over a clause propagates Words * 64 independent partial
+ * assignments at once. Meant for short clauses, where the per-clause work is a handful of mask operations.
+ */
+template<std::size_t Words>
+class BitPropagator {
+public:
+	typedef LaneMask<Words> Mask;
+	static const std::size_t lanes = 64 * Words;
+
+private:
+	std::shared_ptr<const ClauseStore> _store;
+	std::vector<Mask> _true;
+	std::vector<Mask> _false;
+	std::vector<std::uint32_t> _queue;
+	std::vector<std::uint8_t> _queued;
+	std::vector<Mask> _suffix;
+	Mask _conflict;
+
+	// masks of the variables changed since the last checkpoint, as they were at the checkpoint
+	std::vector<std::uint32_t> _changed;
+	std::vector<Mask> _saved_true;
+	std::vector<Mask> _saved_false;
+	std::vector<std::uint8_t> _is_changed;
+	Mask _saved_conflict;
+
+	void set_true(int literal, const Mask &lanes);
+	void propagate_clause(std::uint32_t clause_id);
+
+public:
+	explicit BitPropagator(std::shared_ptr<const ClauseStore> store);
+
+	// Unassigns every variable in every lane.
+	void reset();
+	// Makes the current state the one rollback returns to.
+	void checkpoint();
+	// Restores the state of the last checkpoint in O(changed variables).
+	void rollback();
+	// Assigns the literal in one lane; assigning a lane both phases of a variable is a conflict there.
+	void assign(int literal, std::size_t lane);
+	// Propagates every lane to a fixpoint; returns the lanes that ran into a conflict.
+	Mask propagate();
+
+	// The variables whose masks changed since the last checkpoint.
+	const std::vector<std::uint32_t> &changed() const { return _changed; }
+	// The lanes where the i-th changed variable got assigned since the last checkpoint.
+	Mask assigned_since_checkpoint(std::size_t i) const { return (_true[_changed[i]] | _false[_changed[i]]) & ~(_saved_true[i] | _saved_false[i]); }
+	const Mask &true_lanes(std::size_t variable) const { return _true[variable]; }
+	const Mask &false_lanes(std::size_t variable) const { return _false[variable]; }
+};
+
+// propagate_assumption_sets evaluated 64 * Words sets per pass of a BitPropagator.
+template<std::size_t Words>
+std::vector<AssumptionResult> propagate_assumption_sets_bitparallel(std::shared_ptr<const ClauseStore> store,
+	const std::vector<std::vector<int>> &assumption_sets);
+
+
+#endif
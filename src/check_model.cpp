@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "cnf/model_check.h"
+
+int main(int argc, char **argv)
+{
+	std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+	const char *paths[2] = {nullptr, nullptr};
+	std::size_t count = 0;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		if(std::strcmp(argv[i], "-j") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0)
+			threads = static_cast<std::size_t>(std::atoi(argv[++i]));
+		else if(count < 2 && (argv[i][0] != '-' || std::strcmp(argv[i], "-") == 0))
+			paths[count++] = argv[i];
+		else
+		{
+			count = 0;
+			break;
+		}
+	}
+
+	if(count != 2)
+	{
+		std::printf("Usage: %s [-j N] formula.cnf model\n", argv[0]);
+		std::printf("  checks that the model (a solver's output) satisfies every clause of the formula\n");
+		std::printf("  -j  number of checking threads (default: one per hardware thread)\n");
+		return -1;
+	}
+
+	ModelBits model;
+	ModelCheck result;
+	std::string error;
+	auto start = std::chrono::steady_clock::now();
+
+	if(!read_model(paths[1], model, error) || !check_dimacs_model(paths[0], model, threads, result, error))
+	{
+		std::printf("%s\n", error.c_str());
+		return -1;
+	}
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::printf("c checked %" PRIu64 " clauses in %.3f s on %zu threads\n", result.clauses, elapsed, threads);
+
+	if(result.falsified > 0)
+	{
+		std::printf("c the model falsifies %" PRIu64 " clauses, the first being clause %" PRIu64 "\n", result.falsified, result.first_falsified + 1);
+		std::printf("s NOT VERIFIED\n");
+		return 1;
+	}
+
+	std::printf("s VERIFIED\n");
+	return 0;
+}
@@ -0,0 +1,347 @@
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "dimacs.h"
+
+/**
+ * The parser sees the input as one byte stream whatever its source: a plain regular file is mapped
+ * and handed over as a single region, anything else is inflated (or copied) by zlib into a buffer
+ * that is refilled when it runs dry. Integers are parsed by hand; the only per-byte cost beyond the
+ * digit arithmetic is the check for the end of the current region.
+ */
+
+namespace {
+
+class Input {
+	const char *_pos;
+	const char *_end;
+	int _fd;
+	bool _owned;
+	void *_map;
+	std::size_t _map_size;
+	gzFile _stream;
+	std::vector<char> _buffer;
+
+	bool refill()
+	{
+		if (_stream == nullptr)
+			return false;
+
+		int count = gzread(_stream, _buffer.data(), static_cast<unsigned>(_buffer.size()));
+
+		if (count <= 0)
+			return false;
+
+		_pos = _buffer.data();
+		_end = _pos + count;
+		return true;
+	}
+
+public:
+	Input() : _pos(nullptr), _end(nullptr), _fd(-1), _owned(false), _map(nullptr), _map_size(0), _stream(nullptr) {}
+
+	~Input()
+	{
+		if (_stream != nullptr)
+			gzclose(_stream);
+		if (_map != nullptr)
+			::munmap(_map, _map_size);
+		if (_owned)
+			::close(_fd);
+	}
+
+	bool open(const char *path, std::string &error)
+	{
+		struct stat status;
+
+		if (path == nullptr || std::strcmp(path, "-") == 0)
+			_fd = STDIN_FILENO;
+		else if ((_fd = ::open(path, O_RDONLY)) < 0)
+		{
+			error = std::string("Cannot open ") + path + ": " + std::strerror(errno);
+			return false;
+		}
+		else
+			_owned = true;
+
+		if (::fstat(_fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+		{
+			void *map = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, _fd, 0);
+
+			const unsigned char *bytes = static_cast<const unsigned char *>(map);
+
+			if (map != MAP_FAILED && !(status.st_size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b))
+			{
+				_map = map;
+				_map_size = static_cast<std::size_t>(status.st_size);
+				::madvise(_map, _map_size, MADV_SEQUENTIAL);
+				_pos = static_cast<const char *>(_map);
+				_end = _pos + _map_size;
+				return true;
+			}
+
+			if (map != MAP_FAILED)
+				::munmap(map, static_cast<std::size_t>(status.st_size));
+		}
+
+		// compressed or not mappable (a pipe, a terminal, an empty file): stream it; zlib gets its
+		// own descriptor since gzclose closes it
+		int fd = ::dup(_fd);
+
+		if (fd < 0 || (_stream = gzdopen(fd, "rb")) == nullptr)
+		{
+			if (fd >= 0)
+				::close(fd);
+			error = std::string("Cannot read ") + (path != nullptr ? path : "standard input");
+			return false;
+		}
+
+		// large buffers keep the reads and the inflate calls few; gzbuffer must come before the first read
+		gzbuffer(_stream, 1 << 20);
+		_buffer.resize(1 << 20);
+		return true;
+	}
+
+	// Bytes left in the mapping, or 0 when the input is streamed.
+	std::size_t mapped_remaining() const { return _map != nullptr ? static_cast<std::size_t>(_end - _pos) : 0; }
+
+	int peek() { return _pos < _end || refill() ? static_cast<unsigned char>(*_pos) : EOF; }
+	void skip() { ++_pos; }
+};
+
+// 2 * variable, plus one for a negative literal
+std::size_t mark_index(int literal) { return literal > 0 ? 2 * static_cast<std::size_t>(literal) : 2 * static_cast<std::size_t>(-literal) + 1; }
+
+bool is_space(int c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+bool is_digit(int c) { return c >= '0' && c <= '9'; }
+
+void skip_spaces(Input &input)
+{
+	while (is_space(input.peek()))
+		input.skip();
+}
+
+void skip_line(Input &input)
+{
+	for (int c = input.peek(); c != EOF && c != '\n'; c = input.peek())
+		input.skip();
+}
+
+// Reads an unsigned decimal number no larger than limit; false if there is none or it is too large.
+bool read_number(Input &input, std::uint64_t limit, std::uint64_t &value)
+{
+	int c = input.peek();
+
+	if (!is_digit(c))
+		return false;
+
+	value = 0;
+	for (; is_digit(c); c = input.peek())
+	{
+		value = 10 * value + static_cast<std::uint64_t>(c - '0');
+		if (value > limit)
+			return false;
+		input.skip();
+	}
+
+	return true;
+}
+
+std::string describe(int c)
+{
+	if (c == EOF)
+		return "end of input";
+
+	char text[32];
+	if (c >= 32 && c < 127)
+		std::snprintf(text, sizeof(text), "'%c'", c);
+	else
+		std::snprintf(text, sizeof(text), "byte 0x%02x", c);
+	return text;
+}
+
+bool read_header(Input &input, DimacsFormula &formula, std::uint64_t &numclause, std::string &error)
+{
+	std::string format;
+	std::uint64_t numvar;
+
+	input.skip();
+	skip_spaces(input);
+	for (int c = input.peek(); c != EOF && !is_space(c); c = input.peek())
+	{
+		format.push_back(static_cast<char>(c));
+		input.skip();
+	}
+
+	if (format != "cnf")
+	{
+		error = "Bad format: " + format;
+		return false;
+	}
+
+	skip_spaces(input);
+	if (!read_number(input, INT_MAX, numvar))
+	{
+		error = "Bad number of variables in the p cnf header";
+		return false;
+	}
+
+	skip_spaces(input);
+	if (!read_number(input, UINT32_MAX - 1, numclause))
+	{
+		error = "Bad number of clauses in the p cnf header";
+		return false;
+	}
+
+	// a literal takes two bytes at least, which bounds the estimate for mapped files
+	std::size_t estimate = 3 * static_cast<std::size_t>(numclause);
+	if (input.mapped_remaining() != 0 && input.mapped_remaining() / 2 < estimate)
+		estimate = input.mapped_remaining() / 2;
+
+	formula.numvar = static_cast<std::size_t>(numvar);
+	formula.offsets.reserve(static_cast<std::size_t>(numclause) + 1);
+	formula.literals.reserve(estimate);
+	return true;
+}
+
+}
+
+bool read_dimacs(const char *path, DimacsFormula &formula, std::string &error)
+{
+	Input input;
+	std::uint64_t numclause = 0;
+	bool header = false;
+
+	formula.numvar = 0;
+	formula.literals.clear();
+	formula.offsets.assign(1, 0);
+
+	if (!input.open(path, error))
+		return false;
+
+	// one clause past the announced ones is enough to tell that there are too many
+	while (!header || formula.size() <= numclause)
+	{
+		skip_spaces(input);
+		int c = input.peek();
+
+		if (c == EOF || (c == '%' && header))
+			break;
+
+		if (c == 'c')
+		{
+			skip_line(input);
+			continue;
+		}
+
+		if (c == 'p' && !header)
+		{
+			if (!read_header(input, formula, numclause, error))
+				return false;
+			header = true;
+			continue;
+		}
+
+		if (!header)
+		{
+			error = "Expected a p cnf header, found " + describe(c);
+			return false;
+		}
+
+		bool negative = c == '-';
+		std::uint64_t variable;
+
+		if (negative)
+			input.skip();
+
+		if (!read_number(input, formula.numvar, variable))
+		{
+			error = "Bad or out-of-range literal in clause " + std::to_string(formula.size() + 1) + " near " + describe(input.peek());
+			return false;
+		}
+
+		if (variable != 0)
+			formula.literals.push_back(negative ? -static_cast<int>(variable) : static_cast<int>(variable));
+		else if (formula.literals.size() < UINT32_MAX)
+			formula.offsets.push_back(static_cast<std::uint32_t>(formula.literals.size()));
+		else
+		{
+			error = "Too many literals";
+			return false;
+		}
+	}
+
+	if (!header)
+	{
+		error = "Missing p cnf header";
+		return false;
+	}
+
+	if (formula.size() < numclause)
+	{
+		error = "Expected " + std::to_string(numclause) + " clauses, found " + std::to_string(formula.size());
+		return false;
+	}
+
+	if (formula.size() > numclause || formula.literals.size() > formula.offsets.back())
+	{
+		error = "Expected " + std::to_string(numclause) + " clauses, found more";
+		return false;
+	}
+
+	return true;
+}
+
+void remove_redundancy(std::size_t numvar, std::vector<int> &literals, std::vector<std::uint32_t> &offsets)
+{
+	std::vector<std::uint8_t> mark(2 * numvar + 2, 0);
+	std::size_t numclause = offsets.empty() ? 0 : offsets.size() - 1;
+	std::size_t kept = 0;
+	std::uint32_t end = 0;
+	std::uint32_t read = offsets.empty() ? 0 : offsets[0];
+
+	// clauses only ever move towards the front, so offsets[c + 1] is read before it is overwritten
+	for (std::size_t c = 0; c < numclause; ++c)
+	{
+		std::uint32_t read_end = offsets[c + 1];
+		std::uint32_t begin = end;
+		bool tautology = false;
+
+		for (; read < read_end; ++read)
+		{
+			int literal = literals[read];
+
+			if (mark[mark_index(-literal)])
+				tautology = true;
+			else if (!mark[mark_index(literal)])
+			{
+				mark[mark_index(literal)] = 1;
+				literals[end++] = literal;
+			}
+		}
+
+		for (std::uint32_t i = begin; i < end; ++i)
+			mark[mark_index(literals[i])] = 0;
+
+		if (tautology)
+			end = begin;
+		else
+			offsets[++kept] = end;
+	}
+
+	literals.resize(end);
+	offsets.resize(kept + 1);
+	offsets[0] = 0;
+}
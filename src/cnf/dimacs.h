@@ -0,0 +1,33 @@
+#ifndef _DIMACS
+#define _DIMACS
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A CNF formula as it appears in the input: clause literals back to back, delimited by offsets
+// (clause c is literals[offsets[c]] .. literals[offsets[c + 1] - 1]).
+struct DimacsFormula {
+	std::size_t numvar;
+	std::vector<int> literals;
+	std::vector<std::uint32_t> offsets;
+
+	DimacsFormula() : numvar(0) {}
+
+	std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+// Reads a DIMACS CNF file in one pass. Plain regular files are mapped into memory; gzip-compressed
+// files, stdin (a null path or "-"), pipes and anything else that cannot be mapped are streamed
+// through zlib, which passes uncompressed data through unchanged. Returns false and describes the
+// problem in error when the input is malformed, including when it holds fewer or more clauses than
+// the header announces.
+bool read_dimacs(const char *path, DimacsFormula &formula, std::string &error);
+
+// Removes duplicate literals from every clause and tautological clauses altogether, compacting
+// literals and offsets in place. Literals must lie within [-numvar, numvar].
+void remove_redundancy(std::size_t numvar, std::vector<int> &literals, std::vector<std::uint32_t> &offsets);
+
+
+#endif
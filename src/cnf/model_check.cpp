@@ -0,0 +1,494 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "model_check.h"
+
+/**
+ * Clauses are checked a block at a time: first the truth of every literal of the block goes into a
+ * bitmap, eight lookups at a time with AVX2 gathers where available, then each clause is satisfied
+ * when its range of the bitmap has a bit set, which takes a word test or two for short clauses. Blocks
+ * hold up to 64K literals so that the bitmap stays in L1.
+ */
+
+namespace {
+
+const std::size_t block_literals = 1 << 16;
+
+// Sets bit i of truth for every literal i of literals[0 .. count) that the model makes true.
+void evaluate(const int *literals, std::size_t count, const ModelBits &model, std::vector<std::uint64_t> &truth)
+{
+	std::uint32_t spare = static_cast<std::uint32_t>(model.numvar + 1);
+	std::size_t i = 0;
+
+	truth.assign((count + 63) / 64, 0);
+
+#ifdef __AVX2__
+	// the bitset read as 32-bit words, which on x86 is the same bit order
+	const int *words = reinterpret_cast<const int *>(model.bits.data());
+	const __m256i limit = _mm256_set1_epi32(static_cast<int>(spare)), low = _mm256_set1_epi32(31);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i literal = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(literals + i));
+		__m256i variable = _mm256_min_epu32(_mm256_abs_epi32(literal), limit);
+		__m256i index = _mm256_add_epi32(_mm256_slli_epi32(variable, 1), _mm256_srli_epi32(literal, 31));
+		__m256i word = _mm256_i32gather_epi32(words, _mm256_srli_epi32(index, 5), 4);
+		__m256i bit = _mm256_slli_epi32(_mm256_srlv_epi32(word, _mm256_and_si256(index, low)), 31);
+		std::uint64_t mask = static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(bit)));
+
+		truth[i / 64] |= mask << (i % 64);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		int literal = literals[i];
+		std::uint32_t variable = std::min(static_cast<std::uint32_t>(literal > 0 ? literal : -literal), spare);
+		std::size_t index = 2 * static_cast<std::size_t>(variable) + (literal < 0);
+
+		truth[i / 64] |= ((model.bits[index / 64] >> (index % 64)) & 1) << (i % 64);
+	}
+}
+
+// Whether any bit in [begin, end) is set.
+bool any(const std::vector<std::uint64_t> &truth, std::size_t begin, std::size_t end)
+{
+	if (begin == end)
+		return false;
+
+	std::size_t first = begin / 64, last = (end - 1) / 64;
+	std::uint64_t head = ~std::uint64_t(0) << (begin % 64);
+	std::uint64_t tail = ~std::uint64_t(0) >> (63 - (end - 1) % 64);
+
+	if (first == last)
+		return (truth[first] & head & tail) != 0;
+
+	if (truth[first] & head)
+		return true;
+
+	for (std::size_t w = first + 1; w < last; ++w)
+		if (truth[w])
+			return true;
+
+	return (truth[last] & tail) != 0;
+}
+
+// Checks the clauses delimited by ends (clause k ending at literals[ends[k]], the first starting at
+// literals[0]) and adds them to tally.
+void check_clauses(const int *literals, const std::uint32_t *ends, std::size_t count, const ModelBits &model,
+	std::vector<std::uint64_t> &truth, ModelCheck &tally)
+{
+	std::size_t k = 0;
+
+	while (k < count)
+	{
+		// a block of whole clauses, at least one
+		std::size_t begin = k == 0 ? 0 : ends[k - 1];
+		std::size_t last = k;
+
+		while (last + 1 < count && ends[last + 1] - begin <= block_literals)
+			++last;
+
+		evaluate(literals + begin, ends[last] - begin, model, truth);
+
+		for (std::size_t start = begin; k <= last; start = ends[k++])
+		{
+			if (any(truth, start - begin, ends[k] - begin))
+				continue;
+
+			if (tally.falsified++ == 0)
+				tally.first_falsified = tally.clauses + k;
+		}
+	}
+
+	tally.clauses += count;
+}
+
+// Checks clauses [begin, end) of a formula; first_falsified in tally counts from begin.
+void check_range(const DimacsFormula &formula, std::size_t begin, std::size_t end, const ModelBits &model, ModelCheck &tally)
+{
+	std::vector<std::uint64_t> truth;
+	std::vector<std::uint32_t> ends(formula.offsets.begin() + static_cast<std::ptrdiff_t>(begin) + 1,
+		formula.offsets.begin() + static_cast<std::ptrdiff_t>(end) + 1);
+
+	for (std::uint32_t &e : ends)
+		e -= formula.offsets[begin];
+
+	check_clauses(formula.literals.data() + formula.offsets[begin], ends.data(), ends.size(), model, truth, tally);
+}
+
+// A line-aligned piece of a mapped DIMACS file. Its literals up to the first 0 end a clause begun in an
+// earlier chunk and those after the last 0 begin one that a later chunk ends; only the clauses in between
+// are checked within the chunk.
+struct Chunk {
+	const char *begin;
+	const char *end;
+	std::uint64_t head_literals;
+	bool head_true;
+	bool has_zero;
+	ModelCheck inner;
+	std::uint64_t tail_literals;
+	bool tail_true;
+	// the chunk holds a % line, the end of the formula in SATLIB files
+	bool terminated;
+	std::string error;
+
+	Chunk() : begin(nullptr), end(nullptr), head_literals(0), head_true(false), has_zero(false), tail_literals(0),
+		tail_true(false), terminated(false) {}
+};
+
+bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// Whether any of the literals is true.
+bool any_true(const std::vector<int> &literals, const ModelBits &model)
+{
+	for (int literal : literals)
+		if (model.is_true(literal))
+			return true;
+	return false;
+}
+
+void check_chunk(Chunk &chunk, const char *file, std::size_t numvar, const ModelBits &model)
+{
+	std::vector<int> literals;
+	std::vector<std::uint32_t> ends;
+	std::vector<std::uint64_t> truth;
+	const char *p = chunk.begin;
+
+	while (p < chunk.end)
+	{
+		char c = *p;
+
+		if (is_space(c))
+		{
+			++p;
+			continue;
+		}
+
+		if (c == 'c')
+		{
+			p = static_cast<const char *>(std::memchr(p, '\n', static_cast<std::size_t>(chunk.end - p)));
+			p = p == nullptr ? chunk.end : p;
+			continue;
+		}
+
+		if (c == '%')
+		{
+			chunk.terminated = true;
+			break;
+		}
+
+		const char *token = p;
+		bool negative = c == '-';
+		std::uint64_t variable = 0;
+
+		p += negative;
+		while (p < chunk.end && is_digit(*p) && variable <= numvar)
+			variable = 10 * variable + static_cast<std::uint64_t>(*p++ - '0');
+
+		if (p == token + negative || variable > numvar || (p < chunk.end && !is_space(*p)))
+		{
+			chunk.error = "Bad or out-of-range literal at byte " + std::to_string(token - file);
+			return;
+		}
+
+		if (variable != 0)
+		{
+			literals.push_back(negative ? -static_cast<int>(variable) : static_cast<int>(variable));
+			continue;
+		}
+
+		if (!chunk.has_zero)
+		{
+			chunk.has_zero = true;
+			chunk.head_literals = literals.size();
+			chunk.head_true = any_true(literals, model);
+			literals.clear();
+			continue;
+		}
+
+		ends.push_back(static_cast<std::uint32_t>(literals.size()));
+
+		if (literals.size() >= block_literals)
+		{
+			check_clauses(literals.data(), ends.data(), ends.size(), model, truth, chunk.inner);
+			literals.clear();
+			ends.clear();
+		}
+	}
+
+	check_clauses(literals.data(), ends.data(), ends.size(), model, truth, chunk.inner);
+	literals.erase(literals.begin(), literals.begin() + (ends.empty() ? 0 : ends.back()));
+
+	if (chunk.has_zero)
+	{
+		chunk.tail_literals = literals.size();
+		chunk.tail_true = any_true(literals, model);
+	}
+	else
+	{
+		chunk.head_literals = literals.size();
+		chunk.head_true = any_true(literals, model);
+	}
+}
+
+// Reads the p cnf line, skipping comments before it; returns where the clauses start, or null.
+const char *read_header(const char *p, const char *end, std::size_t &numvar, std::uint64_t &numclause)
+{
+	while (p < end)
+	{
+		if (is_space(*p))
+			++p;
+		else if (*p == 'c')
+		{
+			p = static_cast<const char *>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+			p = p == nullptr ? end : p;
+		}
+		else
+			break;
+	}
+
+	const char *line = static_cast<const char *>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+	std::string header(p, line == nullptr ? end : line);
+	unsigned long long variables, clauses;
+	char trailing;
+
+	if (std::sscanf(header.c_str(), "p cnf %llu %llu %c", &variables, &clauses, &trailing) != 2 || variables > INT32_MAX)
+		return nullptr;
+
+	numvar = static_cast<std::size_t>(variables);
+	numclause = clauses;
+	return line == nullptr ? end : line + 1;
+}
+
+bool check_mapped(const char *file, std::size_t size, const ModelBits &model, std::size_t threads, ModelCheck &result, std::string &error)
+{
+	std::size_t numvar;
+	std::uint64_t numclause;
+	const char *end = file + size;
+	const char *start = read_header(file, end, numvar, numclause);
+
+	if (start == nullptr)
+	{
+		error = "Expected a p cnf header";
+		return false;
+	}
+
+	// a chunk per thread, but none under 1 MB, each extended to the end of its last line
+	std::size_t count = std::max<std::size_t>(1, std::min<std::size_t>(threads, static_cast<std::size_t>(end - start) >> 20));
+	std::vector<Chunk> chunks(count);
+	const char *p = start;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const char *stop = i + 1 == count ? end : std::max(p, start + static_cast<std::size_t>(end - start) * (i + 1) / count);
+		const char *line = static_cast<const char *>(std::memchr(stop, '\n', static_cast<std::size_t>(end - stop)));
+
+		chunks[i].begin = p;
+		chunks[i].end = stop == end || line == nullptr ? end : line + 1;
+		p = chunks[i].end;
+	}
+
+	std::vector<std::thread> workers;
+	for (std::size_t i = 1; i < count; ++i)
+		workers.emplace_back(check_chunk, std::ref(chunks[i]), file, numvar, std::cref(model));
+	check_chunk(chunks[0], file, numvar, model);
+	for (std::thread &worker : workers)
+		worker.join();
+
+	// stitch the clauses that span chunks
+	std::uint64_t open_literals = 0;
+	bool open_true = false;
+
+	result = ModelCheck();
+	for (const Chunk &chunk : chunks)
+	{
+		if (!chunk.error.empty())
+		{
+			error = chunk.error;
+			return false;
+		}
+
+		open_literals += chunk.head_literals;
+		open_true = open_true || chunk.head_true;
+
+		if (chunk.has_zero)
+		{
+			if (!open_true && result.falsified++ == 0)
+				result.first_falsified = result.clauses;
+			++result.clauses;
+
+			if (chunk.inner.falsified > 0 && result.falsified == 0)
+				result.first_falsified = result.clauses + chunk.inner.first_falsified;
+			result.clauses += chunk.inner.clauses;
+			result.falsified += chunk.inner.falsified;
+
+			open_literals = chunk.tail_literals;
+			open_true = chunk.tail_true;
+		}
+
+		if (chunk.terminated)
+			break;
+	}
+
+	if (open_literals > 0)
+	{
+		error = "The last clause is not terminated by 0";
+		return false;
+	}
+
+	if (result.clauses != numclause)
+	{
+		error = "Expected " + std::to_string(numclause) + " clauses, found " + std::to_string(result.clauses);
+		return false;
+	}
+
+	if (result.falsified == 0)
+		result.first_falsified = result.clauses;
+
+	return true;
+}
+
+}
+
+bool read_model(const char *path, ModelBits &model, std::string &error)
+{
+	std::FILE *in = std::fopen(path, "r");
+	std::string text;
+	char buffer[1 << 16];
+
+	if (in == nullptr)
+	{
+		error = std::string("Cannot open ") + path + ": " + std::strerror(errno);
+		return false;
+	}
+
+	// solvers print a model on a single line as often as not, so the whole file is read first
+	for (std::size_t n; (n = std::fread(buffer, 1, sizeof(buffer), in)) > 0; )
+		text.append(buffer, n);
+	std::fclose(in);
+
+	model = ModelBits();
+
+	for (const char *p = text.c_str(), *end = p + text.size(); p < end; )
+	{
+		const char *eol = static_cast<const char *>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+		std::string line(p, eol == nullptr ? end : eol);
+		const char *q = line.c_str();
+
+		p = eol == nullptr ? end : eol + 1;
+
+		if (std::strncmp(q, "s UNSAT", 7) == 0 || std::strncmp(q, "UNSAT", 5) == 0)
+		{
+			error = std::string(path) + " says the formula is unsatisfiable";
+			return false;
+		}
+
+		if (*q == 'c' || *q == 's' || std::strncmp(q, "SAT", 3) == 0)
+			continue;
+
+		if (*q == 'v')
+			++q;
+
+		for (char *next; ; q = next)
+		{
+			long literal = std::strtol(q, &next, 10);
+
+			if (next == q)
+				break;
+
+			if (literal < -INT32_MAX || literal > INT32_MAX || model.is_true(-static_cast<int>(literal)))
+			{
+				error = std::string(path) + ": bad literal or conflicting assignment " + std::to_string(literal);
+				return false;
+			}
+
+			if (literal != 0)
+				model.set(static_cast<int>(literal));
+		}
+	}
+
+	return true;
+}
+
+ModelCheck check_model(const DimacsFormula &formula, const ModelBits &model, std::size_t threads)
+{
+	std::size_t size = formula.size();
+	std::size_t count = std::max<std::size_t>(1, std::min<std::size_t>(threads, size >> 16));
+	std::vector<ModelCheck> tallies(count);
+	std::vector<std::thread> workers;
+
+	for (std::size_t i = 1; i < count; ++i)
+		workers.emplace_back(check_range, std::cref(formula), size * i / count, size * (i + 1) / count, std::cref(model), std::ref(tallies[i]));
+	check_range(formula, 0, size / count, model, tallies[0]);
+	for (std::thread &worker : workers)
+		worker.join();
+
+	ModelCheck result;
+	for (const ModelCheck &tally : tallies)
+	{
+		if (tally.falsified > 0 && result.falsified == 0)
+			result.first_falsified = result.clauses + tally.first_falsified;
+		result.clauses += tally.clauses;
+		result.falsified += tally.falsified;
+	}
+
+	if (result.falsified == 0)
+		result.first_falsified = result.clauses;
+
+	return result;
+}
+
+bool check_dimacs_model(const char *path, const ModelBits &model, std::size_t threads, ModelCheck &result, std::string &error)
+{
+	struct stat status;
+	int fd = path == nullptr || std::strcmp(path, "-") == 0 ? -1 : ::open(path, O_RDONLY);
+
+	if (fd >= 0 && ::fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 2)
+	{
+		std::size_t size = static_cast<std::size_t>(status.st_size);
+		void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		const unsigned char *bytes = static_cast<const unsigned char *>(map);
+
+		if (map != MAP_FAILED && !(bytes[0] == 0x1f && bytes[1] == 0x8b))
+		{
+			::madvise(map, size, MADV_SEQUENTIAL);
+			bool ok = check_mapped(static_cast<const char *>(map), size, model, threads, result, error);
+			::munmap(map, size);
+			::close(fd);
+			return ok;
+		}
+
+		if (map != MAP_FAILED)
+			::munmap(map, size);
+	}
+
+	if (fd >= 0)
+		::close(fd);
+
+	DimacsFormula formula;
+
+	if (!read_dimacs(path, formula, error))
+		return false;
+
+	result = check_model(formula, model, threads);
+	return true;
+}
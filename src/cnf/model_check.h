@@ -0,0 +1,70 @@
+#ifndef _MODEL_CHECK
+#define _MODEL_CHECK
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dimacs.h"
+
+// A truth assignment as a bitset over literals rather than variables: bit 2v is set when v is true and
+// bit 2v + 1 when v is false, so looking a literal up is a single bit test and a variable the model
+// leaves out makes neither of its literals true. Variables beyond numvar count as left out: lookups
+// clamp them to variable numvar + 1, which is never set.
+struct ModelBits {
+	std::size_t numvar;
+	std::vector<std::uint64_t> bits;
+
+	explicit ModelBits(std::size_t n = 0) : numvar(n), bits(words(n), 0) {}
+
+	static std::size_t words(std::size_t n) { return (2 * n + 4 + 63) / 64; }
+	static std::size_t index(int literal) { return literal > 0 ? 2 * static_cast<std::size_t>(literal) : 2 * static_cast<std::size_t>(-literal) + 1; }
+
+	// Makes the literal true, growing the model to its variable when needed.
+	void set(int literal)
+	{
+		std::size_t variable = static_cast<std::size_t>(literal > 0 ? literal : -literal);
+
+		if (variable > numvar)
+		{
+			numvar = variable;
+			bits.resize(words(numvar), 0);
+		}
+		bits[index(literal) / 64] |= std::uint64_t(1) << (index(literal) % 64);
+	}
+	bool is_true(int literal) const
+	{
+		std::size_t variable = static_cast<std::size_t>(literal > 0 ? literal : -literal);
+		return variable <= numvar && ((bits[index(literal) / 64] >> (index(literal) % 64)) & 1);
+	}
+};
+
+// The outcome of a check: how many clauses there were, how many the model falsifies and the index
+// of the first of those (or of clauses, when there is none).
+struct ModelCheck {
+	std::uint64_t clauses;
+	std::uint64_t falsified;
+	std::uint64_t first_falsified;
+
+	ModelCheck() : clauses(0), falsified(0), first_falsified(0) {}
+};
+
+// Reads a model from a solver's output: "v" lines (as the DPLL engine and SAT competition solvers print
+// them), a MiniSat result file or bare literals; comment and status lines are skipped and 0 is ignored.
+// Returns false and describes the problem in error when the file is unreadable, says the formula is
+// unsatisfiable, or makes both literals of a variable true.
+bool read_model(const char *path, ModelBits &model, std::string &error);
+
+// Checks every clause of the formula against the model, on up to threads threads.
+ModelCheck check_model(const DimacsFormula &formula, const ModelBits &model, std::size_t threads);
+
+// Checks a DIMACS file against the model without loading it: a plain regular file is mapped and split into
+// line-aligned chunks that the threads parse and check on their own, the clauses spanning two chunks
+// being stitched together afterwards; anything else goes through read_dimacs first. Returns false and
+// describes the problem in error when the file is malformed or holds a different number of clauses
+// than its header announces.
+bool check_dimacs_model(const char *path, const ModelBits &model, std::size_t threads, ModelCheck &result, std::string &error);
+
+
+#endif
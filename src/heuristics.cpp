@@ -0,0 +1,209 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "heuristics.h"
+
+/**
+ * Branching heuristics for the DPLL search. Except for the plain variable order they score
+ * every unassigned variable from the occurrence counts the propagator keeps up to date over
+ * the unresolved clauses, so a pick costs O(vars) and never looks at the clauses themselves.
+ */
+
+// Returns the phase of the unassigned variable with the highest score(positive, negative),
+// where score also reports which phase to take first.
+template<typename Score>
+static int pick_best(const UnitPropagator &propagator, Score score)
+{
+	int best = 0;
+	std::uint64_t best_score = 0;
+
+	for (std::size_t variable = 1; variable <= propagator.numvar(); ++variable)
+	{
+		if (propagator.is_defined(variable))
+			continue;
+
+		int literal = static_cast<int>(variable);
+		bool positive = true;
+		std::uint64_t value = score(literal, positive);
+
+		if (best == 0 || value > best_score)
+		{
+			best = positive ? literal : -literal;
+			best_score = value;
+		}
+	}
+
+	return best;
+}
+
+int OrderHeuristic::pick(const UnitPropagator &propagator)
+{
+	// every variable below the one picked on the previous level is assigned on that level or below;
+	// levels decided without asking the heuristic (or not at all) give no such bound
+	std::size_t level = propagator.decision_level();
+	std::size_t variable = level == 0 || level > _picked.size() ? 1 : _picked[level - 1] + 1;
+
+	while (variable <= propagator.numvar() && propagator.is_defined(variable))
+		++variable;
+
+	if (variable > propagator.numvar())
+		return 0;
+
+	_picked.resize(level + 1);
+	_picked[level] = variable;
+	return static_cast<int>(variable);
+}
+
+int DlisHeuristic::pick(const UnitPropagator &propagator)
+{
+	return pick_best(propagator, [&propagator](int literal, bool &positive) {
+		std::uint64_t pos = propagator.live_count(literal), neg = propagator.live_count(-literal);
+		positive = pos >= neg;
+		return positive ? pos : neg;
+	});
+}
+
+int MomsHeuristic::pick(const UnitPropagator &propagator)
+{
+	bool binary = false;
+
+	for (std::size_t variable = 1; !binary && variable <= propagator.numvar(); ++variable)
+		if (!propagator.is_defined(variable))
+			binary = propagator.binary_count(static_cast<int>(variable)) + propagator.binary_count(-static_cast<int>(variable)) > 0;
+
+	return pick_best(propagator, [&propagator, binary](int literal, bool &positive) {
+		std::uint64_t pos = binary ? propagator.binary_count(literal) : propagator.live_count(literal);
+		std::uint64_t neg = binary ? propagator.binary_count(-literal) : propagator.live_count(-literal);
+		positive = pos >= neg;
+		return ((pos + neg) << 10) + pos * neg;
+	});
+}
+
+int JeroslowWangHeuristic::pick(const UnitPropagator &propagator)
+{
+	return pick_best(propagator, [&propagator](int literal, bool &positive) {
+		std::uint64_t pos = propagator.jw_weight(literal), neg = propagator.jw_weight(-literal);
+		positive = pos >= neg;
+		return pos + neg;
+	});
+}
+
+const std::uint32_t VsidsHeuristic::absent;
+
+VsidsHeuristic::VsidsHeuristic(std::size_t numvar)
+	: _activity(numvar + 1, 0.0), _phase(numvar + 1, 0), _position(numvar + 1, absent), _increment(1.0)
+{
+	for (std::uint32_t variable = 1; variable <= numvar; ++variable)
+		insert(variable);
+}
+
+void VsidsHeuristic::sift_up(std::size_t i)
+{
+	std::uint32_t variable = _heap[i];
+
+	for (; i > 0 && before(variable, _heap[(i - 1) / 2]); i = (i - 1) / 2)
+	{
+		_heap[i] = _heap[(i - 1) / 2];
+		_position[_heap[i]] = static_cast<std::uint32_t>(i);
+	}
+
+	_heap[i] = variable;
+	_position[variable] = static_cast<std::uint32_t>(i);
+}
+
+void VsidsHeuristic::sift_down(std::size_t i)
+{
+	std::uint32_t variable = _heap[i];
+
+	while (2 * i + 1 < _heap.size())
+	{
+		std::size_t child = 2 * i + 1;
+		if (child + 1 < _heap.size() && before(_heap[child + 1], _heap[child]))
+			++child;
+		if (!before(_heap[child], variable))
+			break;
+
+		_heap[i] = _heap[child];
+		_position[_heap[i]] = static_cast<std::uint32_t>(i);
+		i = child;
+	}
+
+	_heap[i] = variable;
+	_position[variable] = static_cast<std::uint32_t>(i);
+}
+
+void VsidsHeuristic::insert(std::uint32_t variable)
+{
+	if (_position[variable] != absent)
+		return;
+
+	_heap.push_back(variable);
+	sift_up(_heap.size() - 1);
+}
+
+int VsidsHeuristic::pick(const UnitPropagator &propagator)
+{
+	while (!_heap.empty())
+	{
+		std::uint32_t variable = _heap[0];
+
+		_position[variable] = absent;
+		_heap[0] = _heap.back();
+		_heap.pop_back();
+		if (!_heap.empty())
+			sift_down(0);
+
+		if (!propagator.is_defined(variable))
+			return _phase[variable] ? static_cast<int>(variable) : -static_cast<int>(variable);
+	}
+
+	return 0;
+}
+
+void VsidsHeuristic::bump(const std::vector<int> &clause)
+{
+	for (int literal : clause)
+	{
+		std::uint32_t variable = static_cast<std::uint32_t>(literal > 0 ? literal : -literal);
+
+		if ((_activity[variable] += _increment) > 1e100)
+		{
+			for (double &activity : _activity)
+				activity *= 1e-100;
+			_increment *= 1e-100;
+		}
+
+		if (_position[variable] != absent)
+			sift_up(_position[variable]);
+	}
+
+	// decaying every activity by 0.95 is the same as growing the increment
+	_increment /= 0.95;
+}
+
+void VsidsHeuristic::unassign(int literal)
+{
+	std::uint32_t variable = static_cast<std::uint32_t>(literal > 0 ? literal : -literal);
+
+	_phase[variable] = literal > 0;
+	insert(variable);
+}
+
+std::unique_ptr<BranchingHeuristic> make_heuristic(const char *name)
+{
+	std::unique_ptr<BranchingHeuristic> heuristic;
+
+	if (std::strcmp(name, "order") == 0)
+		heuristic.reset(new OrderHeuristic());
+	else if (std::strcmp(name, "dlis") == 0)
+		heuristic.reset(new DlisHeuristic());
+	else if (std::strcmp(name, "moms") == 0)
+		heuristic.reset(new MomsHeuristic());
+	else if (std::strcmp(name, "jw") == 0)
+		heuristic.reset(new JeroslowWangHeuristic());
+
+	return heuristic;
+}
@@ -0,0 +1,83 @@
+#ifndef _HEURISTICS
+#define _HEURISTICS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "unit_propagation.h"
+
+class BranchingHeuristic {
+public:
+	virtual ~BranchingHeuristic() {}
+
+	// Returns the literal to branch on next, or 0 if every variable is assigned.
+	virtual int pick(const UnitPropagator &propagator) = 0;
+	// Whether pick relies on the propagator's occurrence counts.
+	virtual bool needs_counts() const { return true; }
+	// Forgets any per-level state; called when the search restarts below a new prefix.
+	virtual void reset() {}
+};
+
+// Branches on the lowest unassigned variable, positive phase first.
+class OrderHeuristic : public BranchingHeuristic {
+	std::vector<std::size_t> _picked;
+
+public:
+	int pick(const UnitPropagator &propagator) override;
+	bool needs_counts() const override { return false; }
+	void reset() override { _picked.clear(); }
+};
+
+// Dynamic largest individual sum: the literal occurring in most unresolved clauses.
+class DlisHeuristic : public BranchingHeuristic {
+public:
+	int pick(const UnitPropagator &propagator) override;
+};
+
+// Maximum occurrences in clauses of minimum size, taken over the clauses with two free literals;
+// while there are none it falls back to the counts over all unresolved clauses.
+class MomsHeuristic : public BranchingHeuristic {
+public:
+	int pick(const UnitPropagator &propagator) override;
+};
+
+// Two-sided Jeroslow-Wang: the variable with the largest combined weight, in its heavier phase.
+class JeroslowWangHeuristic : public BranchingHeuristic {
+public:
+	int pick(const UnitPropagator &propagator) override;
+};
+
+// VSIDS for clause learning: every variable of a learnt clause is bumped by a growing increment, and the
+// most active unassigned variable is branched on in the phase it had last (phase saving). Variables sit
+// in a binary heap; assigned ones are dropped lazily when picking and come back through unassign.
+class VsidsHeuristic : public BranchingHeuristic {
+	std::vector<double> _activity;
+	std::vector<std::uint8_t> _phase;
+	std::vector<std::uint32_t> _heap;
+	std::vector<std::uint32_t> _position;
+	double _increment;
+
+	static const std::uint32_t absent = UINT32_MAX;
+	bool before(std::uint32_t a, std::uint32_t b) const { return _activity[a] > _activity[b] || (_activity[a] == _activity[b] && a < b); }
+	void sift_up(std::size_t i);
+	void sift_down(std::size_t i);
+	void insert(std::uint32_t variable);
+
+public:
+	explicit VsidsHeuristic(std::size_t numvar);
+
+	int pick(const UnitPropagator &propagator) override;
+	bool needs_counts() const override { return false; }
+	// Bumps the variables of a learnt clause and decays every other activity.
+	void bump(const std::vector<int> &clause);
+	// Saves the phase of a literal about to be unassigned and makes its variable eligible again.
+	void unassign(int literal);
+};
+
+// Creates the heuristic called name (order, dlis, moms or jw); returns nullptr for an unknown name.
+std::unique_ptr<BranchingHeuristic> make_heuristic(const char *name);
+
+
+#endif
@@ -22,8 +22,10 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_Dimacs_h
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string>
 
-#include "utils/ParseUtils.h"
+#include "cnf/dimacs.h"
 #include "core/SolverTypes.h"
 
 namespace Minisat {
@@ -31,57 +33,26 @@ namespace Minisat {
 //=================================================================================================
 // DIMACS Parser:
 
-template<class B, class Solver>
-static void readClause(B& in, Solver& S, vec<Lit>& lits) {
-    int     parsed_lit, var;
-    lits.clear();
-    for (;;){
-        parsed_lit = parseInt(in);
-        if (parsed_lit == 0) break;
-        var = abs(parsed_lit)-1;
-        while (var >= S.nVars()) S.newVar();
-        lits.push( (parsed_lit > 0) ? mkLit(var) : ~mkLit(var) );
-    }
-}
-
-template<class B, class Solver>
-static void parse_DIMACS_main(B& in, Solver& S) {
-    vec<Lit> lits;
-    int vars    = 0;
-    int clauses = 0;
-    int cnt     = 0;
-    for (;;){
-        skipWhitespace(in);
-        if (*in == EOF) break;
-        else if (*in == 'p'){
-            if (eagerMatch(in, "p cnf")){
-                vars    = parseInt(in);
-                clauses = parseInt(in);
-                // SATRACE'06 hack
-                // if (clauses > 4000000)
-                //     S.eliminate(true);
-            }else{
-                printf("PARSE ERROR! Unexpected char: %c\n", *in), exit(3);
-            }
-        } else if (*in == 'c' || *in == 'p')
-            skipLine(in);
-        else{
-            cnt++;
-            readClause(in, S, lits);
-            S.addClause_(lits); }
-    }
-    if (vars != S.nVars())
-        fprintf(stderr, "WARNING! DIMACS header mismatch: wrong number of variables.\n");
-    if (cnt  != clauses)
-        fprintf(stderr, "WARNING! DIMACS header mismatch: wrong number of clauses.\n");
-}
-
-// Inserts problem into solver.
+// Inserts problem into solver. The input (plain or gzipped DIMACS) is read by the CNF loader
+// shared with the other engines; a NULL path reads standard input.
 //
 template<class Solver>
-static void parse_DIMACS(gzFile input_stream, Solver& S) {
-    StreamBuffer in(input_stream);
-    parse_DIMACS_main(in, S); }
+static void parse_DIMACS(const char* path, Solver& S) {
+    DimacsFormula formula;
+    std::string   error;
+    vec<Lit>      lits;
+    if (!read_dimacs(path, formula, error))
+        printf("PARSE ERROR! %s\n", error.c_str()), exit(3);
+
+    while ((size_t)S.nVars() < formula.numvar) S.newVar();
+    for (size_t c = 0; c < formula.size(); c++){
+        lits.clear();
+        for (uint32_t i = formula.offsets[c]; i < formula.offsets[c + 1]; i++){
+            int parsed_lit = formula.literals[i];
+            int var        = abs(parsed_lit)-1;
+            lits.push( (parsed_lit > 0) ? mkLit(var) : ~mkLit(var) ); }
+        S.addClause_(lits); }
+}
 
 //=================================================================================================
 }
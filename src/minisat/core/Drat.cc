@@ -0,0 +1,154 @@
+/****************************************************************************************[Drat.cc]
+Binary DRAT proof output, see Drat.h.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mtl/XAlloc.h"
+#include "core/Drat.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Constructor/Destructor:
+
+
+DratWriter::DratWriter() :
+    fd(-1), buf(NULL), used(0), cap(0), spare(NULL), failed(false)
+  , async(false), pending(NULL), pending_size(0), done(false)
+{}
+
+
+DratWriter::~DratWriter()
+{
+    close();
+}
+
+
+//=================================================================================================
+// Methods:
+
+
+bool DratWriter::open(const char* path, bool async_)
+{
+    close();
+
+    fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    cap    = buffer_size;
+    buf    = (char*)xrealloc(NULL, cap);
+    spare  = (char*)xrealloc(NULL, cap);
+    used   = 0;
+    failed = false;
+    done   = false;
+    async  = async_;
+
+    if (async){
+        pthread_mutex_init(&lock, NULL);
+        pthread_cond_init(&cond, NULL);
+        if (pthread_create(&thread, NULL, writer, this) != 0){
+            pthread_mutex_destroy(&lock);
+            pthread_cond_destroy(&cond);
+            async = false; } }
+
+    return true;
+}
+
+
+bool DratWriter::close()
+{
+    if (fd < 0) return !failed;
+
+    flush(0);
+
+    if (async){
+        pthread_mutex_lock(&lock);
+        done = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+        pthread_join(thread, NULL);
+        pthread_mutex_destroy(&lock);
+        pthread_cond_destroy(&cond);
+        async = false; }
+
+    if (::close(fd) != 0) failed = true;
+    fd = -1;
+    free(buf);
+    free(spare);
+    buf = spare = NULL;
+    used = cap = 0;
+
+    return !failed;
+}
+
+
+void DratWriter::write(const char* data, int size)
+{
+    while (size > 0 && !failed){
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0){ failed = true; break; }
+        data += n;
+        size -= (int)n; }
+}
+
+
+void DratWriter::flush(int bytes)
+{
+    if (used > 0){
+        if (!async)
+            write(buf, used);
+        else{
+            // Wait for the previous buffer to be written, then hand this one over and fill that one:
+            pthread_mutex_lock(&lock);
+            while (pending != NULL)
+                pthread_cond_wait(&cond, &lock);
+            pending      = buf;
+            pending_size = used;
+            buf          = spare;
+            spare        = NULL;
+            pthread_cond_broadcast(&cond);
+            pthread_mutex_unlock(&lock); }
+        used = 0; }
+
+    if (bytes > cap){
+        // A clause too large for the buffers: both are grown once the writer is done with its own.
+        if (async){
+            pthread_mutex_lock(&lock);
+            while (pending != NULL)
+                pthread_cond_wait(&cond, &lock);
+            pthread_mutex_unlock(&lock); }
+        while (cap < bytes) cap *= 2;
+        buf   = (char*)xrealloc(buf, cap);
+        spare = (char*)xrealloc(spare, cap); }
+}
+
+
+void* DratWriter::writer(void* self)
+{
+    DratWriter& w = *(DratWriter*)self;
+
+    pthread_mutex_lock(&w.lock);
+    for (;;){
+        while (w.pending == NULL && !w.done)
+            pthread_cond_wait(&w.cond, &w.lock);
+        if (w.pending == NULL) break;
+
+        char* data = w.pending;
+        int   size = w.pending_size;
+        pthread_mutex_unlock(&w.lock);
+        w.write(data, size);
+        pthread_mutex_lock(&w.lock);
+
+        w.spare   = data;
+        w.pending = NULL;
+        pthread_cond_broadcast(&w.cond);
+    }
+    pthread_mutex_unlock(&w.lock);
+
+    return NULL;
+}
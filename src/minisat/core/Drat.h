@@ -0,0 +1,87 @@
+/*****************************************************************************************[Drat.h]
+Binary DRAT proof output for the solver: every clause it adds or deletes is encoded into a large
+buffer that is written out in one go when full, either directly or by a background thread while
+the solver fills a second buffer.
+**************************************************************************************************/
+
+#ifndef Minisat_Drat_h
+#define Minisat_Drat_h
+
+#include <pthread.h>
+
+#include "core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// DratWriter -- the proof file:
+
+class DratWriter {
+public:
+    DratWriter();
+    ~DratWriter();
+
+    // Opens the proof file; with 'async', full buffers are written by a background thread.
+    bool open    (const char* path, bool async = false);
+    // Writes out what is buffered and closes the file. Returns false if any write failed.
+    bool close   ();
+
+    // A step adds or deletes a clause. 'except', when given, is left out of the clause written,
+    // which lets a strengthened clause be logged before the literal is removed from it.
+    template<class Lits>
+    void add     (const Lits& c, Lit except = lit_Undef) { step('a', c, except); }
+    template<class Lits>
+    void remove  (const Lits& c)                         { step('d', c, lit_Undef); }
+    void addEmpty()                                      { reserve(2); buf[used++] = 'a'; buf[used++] = 0; }
+
+private:
+    enum { buffer_size = 1 << 22 };
+
+    int             fd;
+    char*           buf;          // The buffer being filled.
+    int             used;
+    int             cap;
+    char*           spare;        // The other buffer, unless the background thread holds it.
+    bool            failed;
+
+    bool            async;
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    char*           pending;      // The buffer handed to the background thread, if any.
+    int             pending_size;
+    bool            done;
+
+    template<class Lits>
+    void step    (char kind, const Lits& c, Lit except);
+    void reserve (int bytes)     { if (cap - used < bytes) flush(bytes); }
+    void flush   (int bytes);     // Empties the buffer, leaving room for at least 'bytes'.
+    void write   (const char* data, int size);
+
+    static void* writer(void* self);
+};
+
+
+// A literal is written as the variable-length encoding of 2 * (var + 1) + sign, seven bits per
+// byte starting with the lowest, and a step ends with a zero byte.
+template<class Lits>
+inline void DratWriter::step(char kind, const Lits& c, Lit except)
+{
+    reserve(5 * c.size() + 2);
+    char* p = buf + used;
+    *p++ = kind;
+    for (int i = 0; i < c.size(); i++){
+        if (c[i] == except) continue;
+        uint32_t u = (uint32_t)toInt(c[i]) + 2;
+        while (u > 127){
+            *p++ = (char)(128 | (u & 127));
+            u >>= 7; }
+        *p++ = (char)u; }
+    *p++ = 0;
+    used = (int)(p - buf);
+}
+
+//=================================================================================================
+}
+
+#endif
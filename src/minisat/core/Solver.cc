@@ -63,6 +63,7 @@ Solver::Solver() :
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
   , garbage_frac     (opt_garbage_frac)
+  , drat             (NULL)
   , restart_first    (opt_restart_first)
   , restart_inc      (opt_restart_inc)
 
@@ -84,6 +85,8 @@ Solver::Solver() :
   , cla_inc            (1)
   , var_inc            (1)
   , watches            (WatcherDeleted(ca))
+  , watches_bin        (WatcherDeleted(ca))
+  , watches_ter        (WatcherDeleted(ca))
   , qhead              (0)
   , simpDB_assigns     (-1)
   , simpDB_props       (0)
@@ -116,6 +119,10 @@ Var Solver::newVar(bool sign, bool dvar)
     int v = nVars();
     watches  .init(mkLit(v, false));
     watches  .init(mkLit(v, true ));
+    watches_bin.init(mkLit(v, false));
+    watches_bin.init(mkLit(v, true ));
+    watches_ter.init(mkLit(v, false));
+    watches_ter.init(mkLit(v, true ));
     assigns  .push(l_Undef);
     vardata  .push(mkVarData(CRef_Undef, 0));
     //activity .push(0);
@@ -135,15 +142,22 @@ bool Solver::addClause_(vec<Lit>& ps)
     if (!ok) return false;
 
     // Check if clause is satisfied and remove false/duplicate literals:
+    if (drat != NULL) ps.copyTo(drat_tmp);
     sort(ps);
     Lit p; int i, j;
     for (i = j = 0, p = lit_Undef; i < ps.size(); i++)
-        if (value(ps[i]) == l_True || ps[i] == ~p)
+        if (value(ps[i]) == l_True || ps[i] == ~p){
+            if (drat != NULL && value(ps[i]) == l_True) drat->remove(drat_tmp);
             return true;
-        else if (value(ps[i]) != l_False && ps[i] != p)
+        }else if (value(ps[i]) != l_False && ps[i] != p)
             ps[j++] = p = ps[i];
     ps.shrink(i - j);
 
+    // The clause actually kept replaces the one given:
+    if (drat != NULL && i != j){
+        drat->add(ps);
+        drat->remove(drat_tmp); }
+
     if (ps.size() == 0)
         return ok = false;
     else if (ps.size() == 1){
@@ -162,8 +176,9 @@ bool Solver::addClause_(vec<Lit>& ps)
 void Solver::attachClause(CRef cr) {
     const Clause& c = ca[cr];
     assert(c.size() > 1);
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws = watchesOf(c);
+    ws[~c[0]].push(Watcher(cr, c[1]));
+    ws[~c[1]].push(Watcher(cr, c[0]));
     if (c.learnt()) learnts_literals += c.size();
     else            clauses_literals += c.size(); }
 
@@ -171,14 +186,15 @@ void Solver::attachClause(CRef cr) {
 void Solver::detachClause(CRef cr, bool strict) {
     const Clause& c = ca[cr];
     assert(c.size() > 1);
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws = watchesOf(c);
     
     if (strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+        remove(ws[~c[0]], Watcher(cr, c[1]));
+        remove(ws[~c[1]], Watcher(cr, c[0]));
     }else{
         // Lazy detaching: (NOTE! Must clean all watcher lists before garbage collecting this clause)
-        watches.smudge(~c[0]);
-        watches.smudge(~c[1]);
+        ws.smudge(~c[0]);
+        ws.smudge(~c[1]);
     }
 
     if (c.learnt()) learnts_literals -= c.size();
@@ -187,6 +203,7 @@ void Solver::detachClause(CRef cr, bool strict) {
 
 void Solver::removeClause(CRef cr) {
     Clause& c = ca[cr];
+    if (drat != NULL) drat->remove(c);
     detachClause(cr);
     // Don't leave pointers to free'd memory!
     if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
@@ -435,6 +452,136 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  propagateWatches : (p : Lit) (ws : vec<Watcher>&)  ->  [Clause*]
+|  
+|  Description:
+|    Propagates 'p' over the clauses of one size, watched by 'ws' (the list of 'p' in 'watches_bin'
+|    for size 2, in 'watches_ter' for size 3 and in 'watches' for size 0, meaning any other size).
+|    Returns the conflicting clause, or CRef_Undef. Each size has a kernel of its own, so that only
+|    the one for longer clauses has to loop over the literals of a clause.
+|  
+|    Post-conditions:
+|      * 'ws' holds the watchers of 'p' that were not moved, even if there was a conflict.
+|________________________________________________________________________________________________@*/
+template<int Size>
+inline CRef Solver::propagateWatches(Lit p, vec<Watcher>& ws)
+{
+    Watcher        *i, *j, *end;
+
+    for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+        // Try to avoid inspecting the clause:
+        Lit blocker = i->blocker;
+        if (value(blocker) == l_True){
+            *j++ = *i++; continue; }
+
+        // Make sure the false literal is data[1]:
+        CRef     cr        = i->cref;
+        Clause&  c         = ca[cr];
+        Lit      false_lit = ~p;
+        if (c[0] == false_lit)
+            c[0] = c[1], c[1] = false_lit;
+        assert(c[1] == false_lit);
+        i++;
+
+        // If 0th watch is true, then clause is already satisfied.
+        Lit     first = c[0];
+        Watcher w     = Watcher(cr, first);
+        if (first != blocker && value(first) == l_True){
+            *j++ = w; continue; }
+
+        // Look for new watch:
+        for (int k = 2; k < c.size(); k++)
+            if (value(c[k]) != l_False){
+                c[1] = c[k]; c[k] = false_lit;
+                watches[~c[1]].push(w);
+                goto NextClause; }
+
+        // Did not find watch -- clause is unit under assignment:
+        *j++ = w;
+        if (value(first) == l_False){
+            // Copy the remaining watches:
+            while (i < end)
+                *j++ = *i++;
+            ws.shrink(i - j);
+            return cr;
+        }else
+            uncheckedEnqueue(first, cr);
+
+    NextClause:;
+    }
+    ws.shrink(i - j);
+
+    return CRef_Undef;
+}
+
+
+// Binary clauses: the blocker is the other literal, so the clause is only looked at to put the
+// implied literal first, as reasons have it. No watcher ever moves.
+template<>
+inline CRef Solver::propagateWatches<2>(Lit p, vec<Watcher>& ws)
+{
+    for (Watcher *i = (Watcher*)ws, *end = i + ws.size();  i != end;  i++){
+        Lit   other = i->blocker;
+        lbool val   = value(other);
+        if (val == l_True) continue;
+        if (val == l_False) return i->cref;
+
+        Clause& c = ca[i->cref];
+        if (c[0] != other)
+            c[1] = c[0], c[0] = other;
+        uncheckedEnqueue(other, i->cref);
+    }
+
+    return CRef_Undef;
+}
+
+
+// Ternary clauses: the only literal that is not watched is data[2].
+template<>
+inline CRef Solver::propagateWatches<3>(Lit p, vec<Watcher>& ws)
+{
+    Watcher        *i, *j, *end;
+
+    for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+        Lit blocker = i->blocker;
+        if (value(blocker) == l_True){
+            *j++ = *i++; continue; }
+
+        CRef     cr        = i->cref;
+        Clause&  c         = ca[cr];
+        Lit      false_lit = ~p;
+        if (c[0] == false_lit)
+            c[0] = c[1], c[1] = false_lit;
+        assert(c[1] == false_lit);
+        i++;
+
+        Lit     first = c[0];
+        Watcher w     = Watcher(cr, first);
+        if (first != blocker && value(first) == l_True){
+            *j++ = w; continue; }
+
+        if (value(c[2]) != l_False){
+            c[1] = c[2]; c[2] = false_lit;
+            watches_ter[~c[1]].push(w);
+            continue; }
+
+        *j++ = w;
+        if (value(first) == l_False){
+            while (i < end)
+                *j++ = *i++;
+            ws.shrink(i - j);
+            return cr;
+        }else
+            uncheckedEnqueue(first, cr);
+    }
+    ws.shrink(i - j);
+
+    return CRef_Undef;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  propagate : [void]  ->  [Clause*]
@@ -451,55 +598,18 @@ CRef Solver::propagate()
     CRef    confl     = CRef_Undef;
     int     num_props = 0;
     watches.cleanAll();
+    watches_bin.cleanAll();
+    watches_ter.cleanAll();
 
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
-        vec<Watcher>&  ws  = watches[p];
-        Watcher        *i, *j, *end;
         num_props++;
 
-        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
-            // Try to avoid inspecting the clause:
-            Lit blocker = i->blocker;
-            if (value(blocker) == l_True){
-                *j++ = *i++; continue; }
-
-            // Make sure the false literal is data[1]:
-            CRef     cr        = i->cref;
-            Clause&  c         = ca[cr];
-            Lit      false_lit = ~p;
-            if (c[0] == false_lit)
-                c[0] = c[1], c[1] = false_lit;
-            assert(c[1] == false_lit);
-            i++;
-
-            // If 0th watch is true, then clause is already satisfied.
-            Lit     first = c[0];
-            Watcher w     = Watcher(cr, first);
-            if (first != blocker && value(first) == l_True){
-                *j++ = w; continue; }
-
-            // Look for new watch:
-            for (int k = 2; k < c.size(); k++)
-                if (value(c[k]) != l_False){
-                    c[1] = c[k]; c[k] = false_lit;
-                    watches[~c[1]].push(w);
-                    goto NextClause; }
-
-            // Did not find watch -- clause is unit under assignment:
-            *j++ = w;
-            if (value(first) == l_False){
-                confl = cr;
-                qhead = trail.size();
-                // Copy the remaining watches:
-                while (i < end)
-                    *j++ = *i++;
-            }else
-                uncheckedEnqueue(first, cr);
-
-        NextClause:;
-        }
-        ws.shrink(i - j);
+        // One kernel per list, the short clauses first:
+        if ((confl = propagateWatches<2>(p, watches_bin[p])) != CRef_Undef
+         || (confl = propagateWatches<3>(p, watches_ter[p])) != CRef_Undef
+         || (confl = propagateWatches<0>(p, watches[p]))     != CRef_Undef)
+            qhead = trail.size();
     }
     propagations += num_props;
     simpDB_props -= num_props;
@@ -629,6 +739,7 @@ lbool Solver::search(int nof_conflicts)
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
             cancelUntil(backtrack_level);
+            if (drat != NULL) drat->add(learnt_clause);
 
             if (learnt_clause.size() == 1){
                 uncheckedEnqueue(learnt_clause[0]);
@@ -879,13 +990,16 @@ void Solver::relocAll(ClauseAllocator& to)
     //
     // for (int i = 0; i < watches.size(); i++)
     watches.cleanAll();
+    watches_bin.cleanAll();
+    watches_ter.cleanAll();
     for (int v = 0; v < nVars(); v++)
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
             // printf(" >>> RELOCING: %s%d\n", sign(p)?"-":"", var(p)+1);
-            vec<Watcher>& ws = watches[p];
-            for (int j = 0; j < ws.size(); j++)
-                ca.reloc(ws[j].cref, to);
+            vec<Watcher>* lists[] = { &watches[p], &watches_bin[p], &watches_ter[p] };
+            for (int k = 0; k < 3; k++)
+                for (int j = 0; j < lists[k]->size(); j++)
+                    ca.reloc((*lists[k])[j].cref, to);
         }
 
     // All reasons:
@@ -0,0 +1,589 @@
+/*************************************************************************************[Checker.cc]
+DRAT proof checking, see Checker.h.
+**************************************************************************************************/
+
+#include "mtl/Alg.h"
+#include "mtl/Sort.h"
+#include "drat/Checker.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Constructor:
+
+
+Checker::Checker() :
+    lemmas(0), core_lemmas(0), rat_lemmas(0), deletions(0), ignored_deletions(0), missing_deletions(0), propagations(0)
+  , failed_step(-1)
+  , nOriginal(0)
+  , qhead_core(0)
+  , qhead(0)
+  , final_step(-1)
+  , final_conflict(0)
+{
+    // Clause ids start from 1:
+    clauses   .push(CRef_Undef);
+    pivots    .push(lit_Undef);
+    active    .push(0);
+    chain     .push(0);
+    hashes    .push(0);
+    hint_start.push(-1);
+    hint_end  .push(-1);
+    buckets   .growTo(1 << 16, 0);
+}
+
+
+//=================================================================================================
+// Problem specification:
+
+
+Var Checker::newVar()
+{
+    int v = nVars();
+    assigns  .push(l_Undef);
+    reasons  .push(0);
+    seen     .push(0);
+    trail_pos.push(0);
+    watches  .push();
+    watches  .push();
+    lit_seen .push(0);
+    lit_seen .push(0);
+    trail    .capacity(v+1);
+    return v;
+}
+
+
+bool Checker::normalize(const vec<Lit>& ps)
+{
+    ps.copyTo(add_tmp);
+    sort(add_tmp);
+    Lit p; int i, j;
+    for (i = j = 0, p = lit_Undef; i < add_tmp.size(); i++)
+        if (add_tmp[i] == ~p)
+            return false;
+        else if (add_tmp[i] != p)
+            add_tmp[j++] = p = add_tmp[i];
+    add_tmp.shrink(i - j);
+    return true;
+}
+
+
+// Commutative, so that the order of the literals does not matter.
+uint64_t Checker::hashClause(const vec<Lit>& ps) const
+{
+    uint64_t sum = 0, x = 0, prod = 1;
+    for (int i = 0; i < ps.size(); i++){
+        uint64_t u = (uint64_t)toInt(ps[i]) + 1;
+        sum  += u;
+        x    ^= u * 0x9e3779b97f4a7c15ULL;
+        prod *= 2 * u + 1; }
+    return sum * 1023 + (prod ^ x);
+}
+
+
+void Checker::insertHash(uint32_t id)
+{
+    if (clauses.size() > 2 * buckets.size()){
+        // Rehash everything listed into twice as many buckets:
+        int size = 2 * buckets.size();
+        while (size < clauses.size()) size *= 2;
+        buckets.clear();
+        buckets.growTo(size, 0);
+        for (int i = 1; i < clauses.size(); i++)
+            if (active[i] && (uint32_t)i != id){
+                uint32_t b = hashes[i] & (buckets.size() - 1);
+                chain[i]   = buckets[b];
+                buckets[b] = i; } }
+
+    uint32_t b = hashes[id] & (buckets.size() - 1);
+    chain[id]  = buckets[b];
+    buckets[b] = id;
+    active[id] = 1;
+}
+
+
+uint32_t Checker::newClause(const vec<Lit>& ps, bool lemma)
+{
+    uint32_t id       = clauses.size();
+    bool     tautology = !normalize(ps);
+
+    clauses   .push(tautology ? CRef_Undef : ca.alloc(add_tmp, false));
+    pivots    .push(lemma && ps.size() > 0 ? ps[0] : lit_Undef);
+    active    .push(0);
+    chain     .push(0);
+    hashes    .push(tautology ? 0 : hashClause(add_tmp));
+    hint_start.push(-1);
+    hint_end  .push(-1);
+
+    if (!tautology) insertHash(id);
+    return id;
+}
+
+
+// Finds a listed clause with the literals of 'ps' and takes it off the list; returns 0 if there is none.
+uint32_t Checker::findClause(const vec<Lit>& ps)
+{
+    if (!normalize(ps)) return 0;
+
+    uint64_t  h     = hashClause(add_tmp);
+    uint32_t* link  = &buckets[h & (buckets.size() - 1)];
+    uint32_t  found = 0;
+
+    for (int i = 0; i < add_tmp.size(); i++)
+        lit_seen[toInt(add_tmp[i])] = 1;
+
+    for (; *link != 0; link = &chain[*link]){
+        if (hashes[*link] != h) continue;
+        const Clause& c = ca[clauses[*link]];
+        if (c.size() != add_tmp.size()) continue;
+        int i = 0;
+        while (i < c.size() && lit_seen[toInt(c[i])]) i++;
+        if (i == c.size()){
+            found      = *link;
+            *link      = chain[found];
+            active[found] = 0;
+            break; }
+    }
+
+    for (int i = 0; i < add_tmp.size(); i++)
+        lit_seen[toInt(add_tmp[i])] = 0;
+
+    return found;
+}
+
+
+bool Checker::addClause_(vec<Lit>& ps)
+{
+    assert(steps.size() == 0);
+    newClause(ps, false);
+    nOriginal++;
+    return true;
+}
+
+
+void Checker::addLemma(const vec<Lit>& ps)
+{
+    Step s = { newClause(ps, true), false, true, 0 };
+    steps.push(s);
+    lemmas++;
+}
+
+
+void Checker::deleteClause(const vec<Lit>& ps)
+{
+    Step s = { findClause(ps), true, true, 0 };
+    if (s.id == 0){
+        s.applied = false;
+        missing_deletions++; }
+    steps.push(s);
+    deletions++;
+}
+
+
+//=================================================================================================
+// Propagation:
+
+
+void Checker::attachClause(uint32_t id) {
+    const Clause& c = ca[clauses[id]];
+    assert(c.size() > 1);
+    watches[toInt(~c[0])].push(Watcher(clauses[id], c[1], id));
+    watches[toInt(~c[1])].push(Watcher(clauses[id], c[0], id)); }
+
+
+void Checker::detachClause(uint32_t id) {
+    const Clause& c = ca[clauses[id]];
+    assert(c.size() > 1);
+    remove(watches[toInt(~c[0])], Watcher(clauses[id], c[1], id));
+    remove(watches[toInt(~c[1])], Watcher(clauses[id], c[0], id)); }
+
+
+// A clause is the reason for its first literal, as in the solver.
+bool Checker::isReason(uint32_t id) const {
+    const Clause& c = ca[clauses[id]];
+    return c.size() > 0 && value(c[0]) == l_True && reasons[var(c[0])] == id; }
+
+
+void Checker::uncheckedEnqueue(Lit p, uint32_t from)
+{
+    assert(value(p) == l_Undef);
+    assigns  [var(p)] = lbool(!sign(p));
+    reasons  [var(p)] = from;
+    trail_pos[var(p)] = trail.size();
+    trail.push_(p);
+}
+
+
+void Checker::cancelUntil(int size)
+{
+    for (int c = trail.size()-1; c >= size; c--)
+        assigns[var(trail[c])] = l_Undef;
+    trail.shrink(trail.size() - size);
+    qhead = qhead_core = size;
+}
+
+
+// Adds the clause at the top level, watching literals that are not false where there are any, and
+// propagates. With a single literal left, the false one watched is the last assigned, so that it is
+// the first to be unassigned again.
+bool Checker::addTopLevel(uint32_t id)
+{
+    Clause& c    = ca[clauses[id]];
+    int     watchable = 0;
+
+    for (int i = 0; i < c.size(); i++)
+        if (value(c[i]) != l_False){
+            Lit p = c[watchable]; c[watchable++] = c[i]; c[i] = p; }
+
+    if (watchable == 1 && c.size() > 1){
+        int latest = 1;
+        for (int i = 2; i < c.size(); i++)
+            if (trail_pos[var(c[i])] > trail_pos[var(c[latest])])
+                latest = i;
+        Lit p = c[1]; c[1] = c[latest]; c[latest] = p; }
+
+    if (c.size() > 1)
+        attachClause(id);
+
+    if (watchable == 0){
+        final_conflict = id;
+        return false; }
+
+    if (watchable == 1 && value(c[0]) == l_Undef)
+        uncheckedEnqueue(c[0], id);
+
+    if ((final_conflict = propagate()) != 0)
+        return false;
+
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  propagateLit : (p : Lit) (core : bool)  ->  [uint32_t]
+|
+|  Description:
+|    Propagates the literal over the core clauses watching it, or over the others, as
+|    'Solver::propagate' does. Returns the conflicting clause, or 0.
+|________________________________________________________________________________________________@*/
+uint32_t Checker::propagateLit(Lit p, bool core)
+{
+    uint32_t      confl = 0;
+    vec<Watcher>& ws    = watches[toInt(p)];
+    Watcher       *i, *j, *end;
+    Lit           false_lit = ~p;
+    propagations++;
+
+    for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+        // Try to avoid inspecting the clause:
+        Lit blocker = i->blocker;
+        if (value(blocker) == l_True){
+            *j++ = *i++; continue; }
+
+        CRef    cr = i->cref;
+        Clause& c  = ca[cr];
+        if ((c.mark() == 1) != core){
+            *j++ = *i++; continue; }
+
+        // Make sure the false literal is data[1]:
+        if (c[0] == false_lit)
+            c[0] = c[1], c[1] = false_lit;
+        assert(c[1] == false_lit);
+        uint32_t id = i->id;
+        i++;
+
+        // If 0th watch is true, then clause is already satisfied.
+        Lit     first = c[0];
+        Watcher w     = Watcher(cr, first, id);
+        if (first != blocker && value(first) == l_True){
+            *j++ = w; continue; }
+
+        // Look for new watch:
+        for (int k = 2; k < c.size(); k++)
+            if (value(c[k]) != l_False){
+                c[1] = c[k]; c[k] = false_lit;
+                watches[toInt(~c[1])].push(w);
+                goto NextClause; }
+
+        // Did not find watch -- clause is unit under assignment:
+        *j++ = w;
+        if (value(first) == l_False){
+            confl = id;
+            qhead = qhead_core = trail.size();
+            // Copy the remaining watches:
+            while (i < end)
+                *j++ = *i++;
+        }else
+            uncheckedEnqueue(first, id);
+
+    NextClause:;
+    }
+    ws.shrink(i - j);
+
+    return confl;
+}
+
+
+// Propagates over the core clauses to a fixpoint before each literal that the others propagate, so
+// that conflicts are found with core clauses where possible.
+uint32_t Checker::propagate()
+{
+    for (;;){
+        while (qhead_core < trail.size()){
+            uint32_t confl = propagateLit(trail[qhead_core++], true);
+            if (confl != 0) return confl; }
+
+        if (qhead == trail.size())
+            return 0;
+
+        uint32_t confl = propagateLit(trail[qhead++], false);
+        if (confl != 0) return confl;
+    }
+}
+
+
+//=================================================================================================
+// Checking:
+
+
+// Marks the clauses that the conflict depends on as core and lists them in 'out_hints' in the order
+// they became unit, the conflicting clause last. Without a conflicting clause, the conflict is that
+// 'p' is true while its negation was assumed.
+void Checker::analyze(uint32_t confl, Lit p, vec<int>& out_hints)
+{
+    int pending = 0;
+
+    out_hints.clear();
+    if (confl != 0){
+        markCore(confl);
+        const Clause& c = ca[clauses[confl]];
+        for (int i = 0; i < c.size(); i++)
+            if (!seen[var(c[i])]){
+                seen[var(c[i])] = 1;
+                pending++; }
+    }else{
+        seen[var(p)] = 1;
+        pending++; }
+
+    for (int i = trail.size()-1; pending > 0; i--){
+        Var v = var(trail[i]);
+        if (!seen[v]) continue;
+        seen[v] = 0;
+        pending--;
+
+        uint32_t r = reasons[v];
+        if (r == 0) continue;       // Assumed.
+
+        markCore(r);
+        out_hints.push(r);
+        const Clause& c = ca[clauses[r]];
+        for (int k = 0; k < c.size(); k++)
+            if (var(c[k]) != v && !seen[var(c[k])]){
+                seen[var(c[k])] = 1;
+                pending++; }
+    }
+
+    for (int i = 0, k = out_hints.size()-1; i < k; i++, k--){
+        int h = out_hints[i]; out_hints[i] = out_hints[k]; out_hints[k] = h; }
+    if (confl != 0)
+        out_hints.push(confl);
+}
+
+
+// Assumes the negation of each literal of the clause except 'skip'. Returns false, with the literal
+// in 'true_lit', when one of them is already true.
+bool Checker::assumeNegation(const Clause& c, Lit skip, Lit& true_lit)
+{
+    for (int i = 0; i < c.size(); i++)
+        if (c[i] == skip)
+            continue;
+        else if (value(c[i]) == l_True){
+            true_lit = c[i];
+            return false;
+        }else if (value(c[i]) == l_Undef)
+            uncheckedEnqueue(~c[i], 0);
+    return true;
+}
+
+
+// Checks the lemma against the clauses in the formula before it: first as RUP, then as RAT on its
+// pivot, where every clause with the pivot's negation must give a RUP resolvent. Hints for RAT are
+// in LRAT form, each such clause as a negative id followed by the hints of its resolvent.
+bool Checker::verifyLemma(uint32_t id, vec<int>& out_hints)
+{
+    const Clause& c   = ca[clauses[id]];
+    int           top = trail.size();
+    Lit           t   = lit_Undef;
+    uint32_t      confl = 0;
+
+    if (!assumeNegation(c, lit_Undef, t) || (confl = propagate()) != 0){
+        analyze(t == lit_Undef ? confl : 0, t, out_hints);
+        cancelUntil(top);
+        return true; }
+
+    Lit pivot = pivots[id];
+    if (pivot == lit_Undef){
+        cancelUntil(top);
+        return false; }
+
+    int assumed = trail.size();
+    out_hints.clear();
+    for (int d = 1; d < clauses.size(); d++){
+        if (!active[d] || clauses[d] == CRef_Undef) continue;
+        const Clause& dc = ca[clauses[d]];
+        int k = 0;
+        while (k < dc.size() && dc[k] != ~pivot) k++;
+        if (k == dc.size()) continue;
+
+        t = lit_Undef;
+        if (assumeNegation(dc, ~pivot, t) && (confl = propagate()) == 0){
+            cancelUntil(top);
+            return false; }
+
+        markCore(d);
+        analyze(t == lit_Undef ? confl : 0, t, rat_hints);
+        out_hints.push(-d);
+        for (int i = 0; i < rat_hints.size(); i++)
+            out_hints.push(rat_hints[i]);
+        cancelUntil(assumed);
+    }
+
+    rat_lemmas++;
+    cancelUntil(top);
+    return true;
+}
+
+
+// Replays the proof at the top level up to the first conflict. Deletions of clauses that are the
+// reason for a top-level literal are ignored, as other checkers do, since solvers routinely delete
+// satisfied clauses while keeping what they implied. Returns false if no conflict is reached.
+bool Checker::forward()
+{
+    for (int i = 0; i < active.size(); i++)
+        active[i] = 0;
+
+    for (int id = 1; id <= nOriginal; id++)
+        if (clauses[id] != CRef_Undef){
+            active[id] = 1;
+            if (!addTopLevel(id)){
+                final_step = -1;
+                return true; } }
+
+    for (int s = 0; s < steps.size(); s++){
+        Step& st = steps[s];
+        st.trail = trail.size();
+
+        if (st.deletion){
+            if (!st.applied)
+                continue;
+            if (isReason(st.id)){
+                st.applied = false;
+                ignored_deletions++;
+                continue; }
+            if (ca[clauses[st.id]].size() > 1)
+                detachClause(st.id);
+            active[st.id] = 0;
+        }else if (clauses[st.id] != CRef_Undef){
+            active[st.id] = 1;
+            if (!addTopLevel(st.id)){
+                final_step = s;
+                return true; }
+        }
+    }
+
+    return false;
+}
+
+
+// Verifies the core lemmas from the conflict back, undoing the proof step by step on the way.
+bool Checker::backward()
+{
+    analyze(final_conflict, lit_Undef, final_hints);
+
+    for (int s = final_step; s >= 0; s--){
+        Step& st = steps[s];
+
+        if (st.deletion){
+            if (st.applied){
+                if (ca[clauses[st.id]].size() > 1)
+                    attachClause(st.id);
+                active[st.id] = 1; }
+            continue; }
+
+        if (clauses[st.id] == CRef_Undef)
+            continue;
+
+        if (ca[clauses[st.id]].size() > 1)
+            detachClause(st.id);
+        active[st.id] = 0;
+        cancelUntil(st.trail);
+
+        if (!isCore(st.id))
+            continue;
+
+        core_lemmas++;
+        if (!verifyLemma(st.id, analyze_hints)){
+            failed_step = s;
+            return false; }
+
+        hint_start[st.id] = hints.size();
+        for (int i = 0; i < analyze_hints.size(); i++)
+            hints.push(analyze_hints[i]);
+        hint_end[st.id] = hints.size();
+    }
+
+    return true;
+}
+
+
+bool Checker::check()
+{
+    failed_step = -1;
+    return forward() && backward();
+}
+
+
+// Core lemmas get ids after the formula's in proof order; the other lemmas are left out. Deletions
+// are kept for the clauses that remain.
+bool Checker::writeLrat(FILE* out)
+{
+    vec<int> lrat_id(clauses.size(), 0);
+    int      next = nOriginal + 1;
+
+    for (int id = 1; id <= nOriginal; id++)
+        lrat_id[id] = id;
+
+    for (int s = 0; s <= final_step; s++){
+        const Step& st = steps[s];
+
+        if (st.deletion){
+            if (st.applied && lrat_id[st.id] != 0)
+                fprintf(out, "%d d %d 0\n", next - 1, lrat_id[st.id]);
+            continue; }
+
+        if (hint_start[st.id] < 0)
+            continue;
+
+        const Clause& c = ca[clauses[st.id]];
+        Lit           p = pivots[st.id];
+        lrat_id[st.id] = next;
+        fprintf(out, "%d", next++);
+        if (p != lit_Undef)
+            fprintf(out, " %s%d", sign(p) ? "-" : "", var(p) + 1);
+        for (int i = 0; i < c.size(); i++)
+            if (c[i] != p)
+                fprintf(out, " %s%d", sign(c[i]) ? "-" : "", var(c[i]) + 1);
+        fprintf(out, " 0");
+        for (int i = hint_start[st.id]; i < hint_end[st.id]; i++)
+            fprintf(out, " %d", hints[i] < 0 ? -lrat_id[-hints[i]] : lrat_id[hints[i]]);
+        fprintf(out, " 0\n");
+    }
+
+    fprintf(out, "%d 0", next);
+    for (int i = 0; i < final_hints.size(); i++)
+        fprintf(out, " %d", lrat_id[final_hints[i]]);
+    fprintf(out, " 0\n");
+
+    return !ferror(out);
+}
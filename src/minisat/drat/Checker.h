@@ -0,0 +1,140 @@
+/**************************************************************************************[Checker.h]
+A DRAT proof checker on the solver's clause allocator and two-watched-literal propagation. A forward
+pass replays the proof at the top level until the formula becomes conflicting; a backward pass
+then verifies only the lemmas that the conflict depends on (the core), most recent first, each by
+reverse unit propagation (RUP) or failing that as a resolution asymmetric tautology (RAT) on its
+first literal. Propagation prefers core clauses so that the core stays small. The hints found for
+the core lemmas can be written out as an LRAT proof for a verified checker.
+**************************************************************************************************/
+
+#ifndef Minisat_Checker_h
+#define Minisat_Checker_h
+
+#include <stdio.h>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Checker -- the main class:
+
+class Checker {
+public:
+
+    Checker();
+
+    // Problem specification, in file order: the formula's clauses and then the proof's steps.
+    // Clauses are numbered from 1 in the order they are given, as in LRAT:
+    //
+    Var     newVar     ();
+    bool    addClause_ (vec<Lit>& ps);          // A clause of the formula (named as in the solver, for 'parse_DIMACS').
+    void    addLemma   (const vec<Lit>& ps);    // A clause the proof adds.
+    void    deleteClause(const vec<Lit>& ps);   // A clause the proof deletes (of the formula or not).
+
+    // Checking:
+    //
+    bool    check      ();                      // Whether the proof shows the formula unsatisfiable.
+    bool    writeLrat  (FILE* out);             // After a successful 'check', writes the core as LRAT.
+
+    int     nVars      ()      const   { return assigns.size(); }
+
+    // Statistics: (read-only member variable)
+    //
+    uint64_t  lemmas, core_lemmas, rat_lemmas, deletions, ignored_deletions, missing_deletions, propagations;
+    int       failed_step;                      // The step that could not be verified, or -1.
+
+protected:
+
+    // Helper structures:
+    //
+    struct Watcher {
+        CRef     cref;
+        Lit      blocker;
+        uint32_t id;
+        Watcher(CRef cr, Lit p, uint32_t i) : cref(cr), blocker(p), id(i) {}
+        bool operator==(const Watcher& w) const { return cref == w.cref; }
+        bool operator!=(const Watcher& w) const { return cref != w.cref; }
+    };
+
+    // A step of the proof: lemma 'id' is added, or clause 'id' is deleted ('id' 0 when there was no such
+    // clause). 'trail' is the size of the top-level trail before the step.
+    struct Step {
+        uint32_t id;
+        bool     deletion;
+        bool     applied;                       // False for deletions that were ignored.
+        int      trail;
+    };
+
+    // Checker state:
+    //
+    ClauseAllocator     ca;
+    vec<CRef>           clauses;                // Clause 'id' is 'ca[clauses[id]]' (CRef_Undef for tautologies).
+    vec<Lit>            pivots;                 // The first literal of each lemma as the proof wrote it.
+    vec<char>           active;                 // Whether clause 'id' is in the formula (while parsing: in the hash table).
+    int                 nOriginal;
+    vec<Step>           steps;
+    vec<vec<Watcher> >  watches;                // 'watches[lit]' lists the clauses watching '~lit', as in the solver.
+    vec<lbool>          assigns;
+    vec<uint32_t>       reasons;                // The clause that implied each variable, 0 for none.
+    vec<Lit>            trail;
+    int                 qhead_core;             // Head of the queue for propagating over core clauses.
+    int                 qhead;                  // Head of the queue for propagating over the others.
+    int                 final_step;             // The step after which the formula is conflicting (-1 for none).
+    uint32_t            final_conflict;         // The clause that is false then.
+
+    // Finding clauses to delete: chained hashing of literal sets.
+    vec<uint32_t>       buckets;
+    vec<uint32_t>       chain;
+    vec<uint64_t>       hashes;
+    vec<char>           lit_seen;
+
+    // LRAT: the hints of each verified lemma (in the order the backward pass found them) and of the
+    // empty clause.
+    vec<int>            hints;
+    vec<int>            hint_start;             // Per clause id, where its hints begin in 'hints' (-1 for none).
+    vec<int>            hint_end;
+    vec<int>            final_hints;
+
+    // Temporaries:
+    //
+    vec<char>           seen;
+    vec<int>            trail_pos;              // Where each assigned variable is on the trail.
+    vec<int>            analyze_hints;
+    vec<int>            rat_hints;
+    vec<Lit>            add_tmp;
+
+    // Main internal methods:
+    //
+    bool     normalize        (const vec<Lit>& ps);                   // Sorted and without duplicates into 'add_tmp'; false for a tautology.
+    uint32_t newClause        (const vec<Lit>& ps, bool lemma);
+    uint64_t hashClause       (const vec<Lit>& ps) const;
+    void     insertHash       (uint32_t id);
+    uint32_t findClause       (const vec<Lit>& ps);
+    void     attachClause     (uint32_t id);
+    void     detachClause     (uint32_t id);
+    bool     addTopLevel      (uint32_t id);                          // Attaches the clause and propagates; false on conflict.
+    bool     isReason         (uint32_t id) const;
+    void     uncheckedEnqueue (Lit p, uint32_t from);
+    uint32_t propagate        ();                                     // Returns the conflicting clause, or 0.
+    uint32_t propagateLit     (Lit p, bool core);
+    void     cancelUntil      (int size);
+    void     markCore         (uint32_t id)   { ca[clauses[id]].mark(1); }
+    bool     isCore           (uint32_t id) const { return clauses[id] != CRef_Undef && ca[clauses[id]].mark() == 1; }
+    void     analyze          (uint32_t confl, Lit p, vec<int>& out_hints);
+    bool     assumeNegation   (const Clause& c, Lit skip, Lit& true_lit);
+    bool     verifyLemma      (uint32_t id, vec<int>& out_hints);
+    bool     forward          ();
+    bool     backward         ();
+
+    // Operations on clauses:
+    //
+    lbool    value            (Var x) const   { return assigns[x]; }
+    lbool    value            (Lit p) const   { return assigns[var(p)] ^ sign(p); }
+};
+
+//=================================================================================================
+}
+
+#endif
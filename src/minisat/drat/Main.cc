@@ -0,0 +1,139 @@
+/*****************************************************************************************[Main.cc]
+The proof checker's front end: reads a formula and a binary DRAT proof, checks the proof and
+optionally writes the part of it that the check used as LRAT.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/System.h"
+#include "utils/Options.h"
+#include "core/Dimacs.h"
+#include "drat/Checker.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Binary DRAT parser:
+
+
+// Each step is 'a' (0x61) or 'd' (0x64) followed by its literals, each the variable-length encoding
+// of 2 * var + sign (seven bits per byte, lowest first), and a zero byte.
+static void parse_DRAT(const char* path, Checker& C)
+{
+    int         fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+        printf("ERROR! Could not open file: %s: %s\n", path, strerror(errno)), exit(1);
+    if (st.st_size == 0){
+        close(fd);
+        return; }
+
+    size_t               size = (size_t)st.st_size;
+    void*                map  = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+        printf("ERROR! Could not read file: %s: %s\n", path, strerror(errno)), exit(1);
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    const unsigned char* begin = (const unsigned char*)map;
+    const unsigned char* end   = begin + size;
+    const unsigned char* p     = begin;
+    vec<Lit>             lits;
+
+    while (p < end){
+        unsigned char kind = *p++;
+        if (kind != 'a' && kind != 'd')
+            printf("PARSE ERROR! Unexpected byte 0x%02x at offset %ld (not a binary DRAT proof?)\n", kind, (long)(p - 1 - begin)), exit(3);
+
+        lits.clear();
+        for (;;){
+            uint64_t u = 0;
+            for (int shift = 0; ; shift += 7){
+                if (p == end || shift > 28)
+                    printf("PARSE ERROR! Truncated or oversized literal at offset %ld\n", (long)(p - begin)), exit(3);
+                u |= (uint64_t)(*p & 127) << shift;
+                if ((*p++ & 128) == 0) break; }
+            if (u == 0) break;
+            if (u < 2 || (u >> 1) > INT32_MAX)
+                printf("PARSE ERROR! Bad literal %llu at offset %ld\n", (unsigned long long)u, (long)(p - begin)), exit(3);
+
+            Var v = (Var)(u >> 1) - 1;
+            while (v >= C.nVars()) C.newVar();
+            lits.push(mkLit(v, u & 1));
+        }
+
+        if (kind == 'a') C.addLemma(lits);
+        else             C.deleteClause(lits);
+    }
+
+    munmap(map, size);
+    close(fd);
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    try {
+        setUsageHelp("USAGE: %s [options] <formula-file> <proof-file>\n\n  where the formula is in plain or gzipped DIMACS and the proof in binary DRAT.\n");
+
+        StringOption lrat   ("MAIN", "lrat",   "Write the checked core of the proof as LRAT to this file.");
+        IntOption    verb   ("MAIN", "verb",   "Verbosity level (0=silent, 1=some).", 1, IntRange(0, 1));
+
+        parseOptions(argc, argv, true);
+
+        if (argc != 3){
+            printf("USAGE: %s [options] <formula-file> <proof-file>\n", argv[0]);
+            exit(1); }
+
+        Checker C;
+        double  initial_time = cpuTime();
+
+        parse_DIMACS(argv[1], C);
+        parse_DRAT(argv[2], C);
+
+        double parsed_time = cpuTime();
+        if (verb > 0)
+            printf("c parsed %d variables, %llu lemmas and %llu deletions in %.2f s\n", C.nVars(),
+                   (unsigned long long)C.lemmas, (unsigned long long)C.deletions, parsed_time - initial_time);
+
+        bool verified = C.check();
+
+        if (verb > 0){
+            printf("c checked %llu core lemmas (%llu as RAT) with %llu propagations in %.2f s\n",
+                   (unsigned long long)C.core_lemmas, (unsigned long long)C.rat_lemmas, (unsigned long long)C.propagations, cpuTime() - parsed_time);
+            if (C.ignored_deletions + C.missing_deletions > 0)
+                printf("c ignored %llu deletions of reason clauses and %llu of missing clauses\n",
+                       (unsigned long long)C.ignored_deletions, (unsigned long long)C.missing_deletions); }
+
+        if (!verified){
+            if (C.failed_step >= 0)
+                printf("c the lemma of step %d is neither RUP nor RAT\n", C.failed_step + 1);
+            else
+                printf("c the proof does not make the formula conflicting\n");
+            printf("s NOT VERIFIED\n");
+            exit(1); }
+
+        if (lrat){
+            FILE* out = fopen(lrat, "wb");
+            if (out == NULL)
+                printf("ERROR! Could not open file: %s\n", (const char*)lrat), exit(1);
+            bool written = C.writeLrat(out);
+            if (fclose(out) != 0 || !written)
+                printf("ERROR! Could not write file: %s\n", (const char*)lrat), exit(1); }
+
+        printf("s VERIFIED\n");
+        exit(0);
+    } catch (OutOfMemoryException&){
+        printf("c out of memory\n");
+        printf("s NOT VERIFIED\n");
+        exit(1);
+    }
+}
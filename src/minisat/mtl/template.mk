@@ -11,7 +11,8 @@ EXEC      ?= $(notdir $(PWD))
 CSRCS      = $(wildcard $(PWD)/*.cc) 
 DSRCS      = $(foreach dir, $(DEPDIR), $(filter-out $(MROOT)/$(dir)/Main.cc, $(wildcard $(MROOT)/$(dir)/*.cc)))
 CHDRS      = $(wildcard $(PWD)/*.h)
-COBJS      = $(CSRCS:.cc=.o) $(DSRCS:.cc=.o)
+CNFSRCS    = $(MROOT)/../cnf/dimacs.cpp
+COBJS      = $(CSRCS:.cc=.o) $(DSRCS:.cc=.o) $(CNFSRCS:.cpp=.o)
 
 PCOBJS     = $(addsuffix p,  $(COBJS))
 DCOBJS     = $(addsuffix d,  $(COBJS))
@@ -24,8 +25,8 @@ LFLAGS    ?= -Wall
 
 COPTIMIZE ?= -O3
 
-CFLAGS    += -I$(MROOT) -D __STDC_LIMIT_MACROS -D __STDC_FORMAT_MACROS
-LFLAGS    += -lz
+CFLAGS    += -I$(MROOT) -I$(MROOT)/.. -D __STDC_LIMIT_MACROS -D __STDC_FORMAT_MACROS
+LFLAGS    += -lz -lpthread
 
 .PHONY : s p d r rs clean 
 
@@ -71,6 +72,11 @@ lib$(LIB)_release.a:	$(filter-out */Main.or, $(RCOBJS))
 	@echo Compiling: $(subst $(MROOT)/,,$@)
 	@$(CXX) $(CFLAGS) -c -o $@ $<
 
+## The CNF loader shared with the other engines
+%.o %.op %.od %.or:	%.cpp
+	@echo Compiling: $(subst $(MROOT)/,,$@)
+	@$(CXX) $(CFLAGS) -c -o $@ $<
+
 ## Linking rules (standard/profile/debug/release)
 $(EXEC) $(EXEC)_profile $(EXEC)_debug $(EXEC)_release $(EXEC)_static:
 	@echo Linking: "$@ ( $(foreach f,$^,$(subst $(MROOT)/,,$f)) )"
@@ -49,6 +49,16 @@ void printStats(Solver& solver)
 }
 
 
+// Ends the proof with the empty clause when the answer is UNSAT and writes it out.
+static void finishProof(Solver& S, bool unsat)
+{
+    if (S.drat == NULL) return;
+    if (unsat) S.drat->addEmpty();
+    if (!S.drat->close())
+        printf("WARNING! Could not write the DRAT proof.\n");
+}
+
+
 static Solver* solver;
 // Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
@@ -86,6 +96,8 @@ int main(int argc, char** argv)
         StringOption dimacs ("MAIN", "dimacs", "If given, stop after preprocessing and write the result to this file.");
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
+        StringOption drat   ("MAIN", "drat",   "Write a binary DRAT proof to this file.");
+        BoolOption   drat_async("MAIN", "drat-async", "Write the proof from a background thread.", false);
 
         parseOptions(argc, argv, true);
         
@@ -95,6 +107,12 @@ int main(int argc, char** argv)
         if (!pre) S.eliminate(true);
 
         S.verbosity = verb;
+
+        DratWriter proof;
+        if (drat){
+            if (!proof.open(drat, drat_async))
+                printf("ERROR! Could not open proof file: %s\n", (const char*)drat), exit(1);
+            S.drat = &proof; }
         
         solver = &S;
         // Use signal handlers that forcibly quit until the solver will be able to respond to
@@ -126,16 +144,11 @@ int main(int argc, char** argv)
         if (argc == 1)
             printf("Reading from standard input... Use '--help' for help.\n");
 
-        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        if (in == NULL)
-            printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
-        
         if (S.verbosity > 0){
             printf("============================[ Problem Statistics ]=============================\n");
             printf("|                                                                             |\n"); }
         
-        parse_DIMACS(in, S);
-        gzclose(in);
+        parse_DIMACS(argc == 1 ? NULL : argv[1], S);
         FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
 
         if (S.verbosity > 0){
@@ -165,6 +178,7 @@ int main(int argc, char** argv)
                 printStats(S);
                 printf("\n"); }
             printf("UNSATISFIABLE\n");
+            finishProof(S, true);
             exit(20);
         }
 
@@ -174,6 +188,7 @@ int main(int argc, char** argv)
             S.toDimacs((const char*)dimacs);
             if (S.verbosity > 0)
                 printStats(S);
+            finishProof(S, false);
             exit(0);
         }
 
@@ -198,6 +213,8 @@ int main(int argc, char** argv)
             fclose(res);
         }
 
+        finishProof(S, ret == l_False);
+
 #ifdef NDEBUG
         exit(ret == l_True ? 10 : ret == l_False ? 20 : 0);     // (faster than "return", which will invoke the destructor for 'Solver')
 #else
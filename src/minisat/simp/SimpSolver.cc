@@ -197,10 +197,13 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
     // if (!find(subsumption_queue, &c))
     subsumption_queue.insert(cr);
 
+    if (drat != NULL) drat->add(c, l);
+
     if (c.size() == 2){
         removeClause(cr);
         c.strengthen(l);
     }else{
+        if (drat != NULL) drat->remove(c);
         detachClause(cr, true);
         c.strengthen(l);
         attachClause(cr);
@@ -507,11 +510,18 @@ bool SimpSolver::eliminateVar(Var v)
         mkElimClause(elimclauses, ~mkLit(v));
     }
 
+    // The resolvents have to be in the proof before the clauses they come from are deleted:
+    vec<Lit>& resolvent = add_tmp;
+    if (drat != NULL)
+        for (int i = 0; i < pos.size(); i++)
+            for (int j = 0; j < neg.size(); j++)
+                if (merge(ca[pos[i]], ca[neg[j]], v, resolvent))
+                    drat->add(resolvent);
+
     for (int i = 0; i < cls.size(); i++)
         removeClause(cls[i]); 
 
     // Produce clauses in cross product:
-    vec<Lit>& resolvent = add_tmp;
     for (int i = 0; i < pos.size(); i++)
         for (int j = 0; j < neg.size(); j++)
             if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
@@ -523,6 +533,10 @@ bool SimpSolver::eliminateVar(Var v)
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watches_bin[ mkLit(v)].size() == 0) watches_bin[ mkLit(v)].clear(true);
+    if (watches_bin[~mkLit(v)].size() == 0) watches_bin[~mkLit(v)].clear(true);
+    if (watches_ter[ mkLit(v)].size() == 0) watches_ter[ mkLit(v)].clear(true);
+    if (watches_ter[~mkLit(v)].size() == 0) watches_ter[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
@@ -550,6 +564,7 @@ bool SimpSolver::substitute(Var v, Lit x)
             subst_clause.push(var(p) == v ? x ^ sign(p) : p);
         }
 
+        if (drat != NULL) drat->add(subst_clause);
         removeClause(cls[i]);
 
         if (!addClause_(subst_clause))
@@ -0,0 +1,437 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "search.h"
+
+/**
+ * DPLL over an explicit decision stack with conflict-directed backjumping. Only the decisions are kept,
+ * everything else is undone through the propagator's trail, so memory does not grow with the depth of
+ * the search. On a conflict the propagator names the decision levels it depends on; a flipped decision
+ * stands in for the levels its failed first branch depended on. The search then jumps straight to the
+ * highest level left and flips that decision, dropping every decision above it, none of which mattered.
+ */
+
+// Replaces flipped decisions in the conflict set by their reasons; returns the highest level left, 0 if none.
+static std::size_t backjump_level(const std::vector<Decision> &decisions, std::vector<std::uint8_t> &conflict)
+{
+	for(std::size_t level = conflict.size(); level-- > 1;)
+	{
+		if(!conflict[level] || !decisions[level - 1].flipped)
+			continue;
+
+		conflict[level] = 0;
+		for(std::uint32_t reason : decisions[level - 1].reasons)
+			conflict[reason] = 1;
+	}
+
+	std::size_t level = conflict.size();
+	while(--level > 0 && !conflict[level]);
+	return level;
+}
+
+bool solve_sat(UnitPropagator &propagator, BranchingHeuristic &heuristic, SearchStats &stats)
+{
+	std::vector<Decision> decisions;
+	std::vector<std::uint8_t> conflict;
+
+	decisions.reserve(propagator.numvar());
+
+	while(true)
+	{
+		int literal = heuristic.pick(propagator);
+
+		if(literal == 0)
+			return true;
+
+		decisions.emplace_back(literal);
+		bool possible = propagator.assign(decisions.back().literal);
+		++stats.decisions;
+
+		while(!possible)
+		{
+			++stats.conflicts;
+			propagator.conflict_levels(conflict);
+			std::size_t level = backjump_level(decisions, conflict);
+
+			if(level == 0)
+				return false;
+
+			decisions.erase(decisions.begin() + static_cast<std::ptrdiff_t>(level), decisions.end());
+			Decision &decision = decisions.back();
+			decision.flipped = true;
+			decision.literal = -decision.literal;
+			decision.reasons.clear();
+			for(std::size_t reason = 1; reason < level; ++reason)
+				if(conflict[reason])
+					decision.reasons.push_back(static_cast<std::uint32_t>(reason));
+
+			propagator.backtrack(level - 1);
+			possible = propagator.assign(decision.literal);
+		}
+	}
+}
+
+/**
+ * Conflict-driven clause learning on the same propagator. Every conflict is resolved back to its first
+ * unique implication point; the learnt clause goes into the propagator, the search jumps back to the
+ * level where the clause becomes unit and propagation asserts it there. Restarts follow the Luby
+ * sequence in units of 100 conflicts; once there are more learnt clauses than a third of the formula
+ * (and at least 5000), the next restart halves them, and the limit grows by a tenth.
+ */
+
+// The i-th element (counting from 0) of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ...
+static std::uint64_t luby(std::uint64_t i)
+{
+	std::uint64_t size = 1, power = 1;
+
+	while(size < i + 1)
+	{
+		size = 2 * size + 1;
+		power *= 2;
+	}
+
+	while(size - 1 != i)
+	{
+		size = (size - 1) / 2;
+		power /= 2;
+		i %= size;
+	}
+
+	return power;
+}
+
+// Backtracks to level, handing every literal it unassigns back to the heuristic.
+static void backjump(UnitPropagator &propagator, VsidsHeuristic &heuristic, std::size_t level)
+{
+	const std::vector<int> &trail = propagator.trail();
+
+	for(std::size_t i = trail.size(); i-- > 0 && propagator.level(static_cast<std::size_t>(std::abs(trail[i]))) > level;)
+		heuristic.unassign(trail[i]);
+
+	propagator.backtrack(level);
+}
+
+bool solve_cdcl(UnitPropagator &propagator, VsidsHeuristic &heuristic, SearchStats &stats)
+{
+	std::vector<int> learnt;
+	std::uint64_t &conflicts = stats.conflicts;
+	std::uint64_t restarts = 0, limit = conflicts + 100 * luby(0);
+	std::size_t max_learnt = std::max<std::size_t>(propagator.clauses() / 3, 5000);
+
+	while(true)
+	{
+		if(conflicts >= limit)
+		{
+			backjump(propagator, heuristic, 0);
+			limit = conflicts + 100 * luby(++restarts);
+
+			if(propagator.learnt_clauses() >= max_learnt)
+			{
+				propagator.reduce_learnt();
+				max_learnt += max_learnt / 10;
+			}
+		}
+
+		int literal = heuristic.pick(propagator);
+
+		if(literal == 0)
+			return true;
+
+		bool possible = propagator.assign(literal);
+		++stats.decisions;
+
+		while(!possible)
+		{
+			if(propagator.decision_level() == 0)
+				return false;
+
+			std::size_t level = propagator.analyze_conflict(learnt);
+			heuristic.bump(learnt);
+			backjump(propagator, heuristic, level);
+			possible = propagator.learn(learnt);
+			++conflicts;
+		}
+	}
+}
+
+/**
+ * Work-stealing parallel DPLL. Every worker runs a chronological version of the search above (a stolen
+ * decision carries no conflict set to jump over it with) on its own propagator over the shared clause
+ * store, with its decision stack guarded by a mutex. An idle worker steals the lowest decision of
+ * another worker whose complement has not been tried yet: it marks that decision flipped, so the owner
+ * will not explore the complement itself, and takes the decisions below it plus the complement as the
+ * prefix of its own subtree. The search ends when a worker finds a model or when every worker is idle.
+ */
+
+namespace {
+
+struct Worker {
+	std::mutex mutex;
+	std::vector<Decision> decisions;
+};
+
+class ParallelSearch {
+	std::shared_ptr<const ClauseStore> _store;
+	const SearchOptions &_options;
+	std::vector<std::unique_ptr<Worker>> _workers;
+	std::atomic<bool> _done;
+	std::atomic<std::size_t> _idle;
+	std::mutex _model_mutex;
+	bool _satisfiable;
+	std::vector<std::uint8_t> &_model;
+	SearchStats &_stats;
+
+	bool steal(std::size_t thief, std::vector<int> &task);
+	bool explore(Worker &self, UnitPropagator &propagator, BranchingHeuristic &heuristic,
+		const std::vector<int> &task, SearchStats &stats);
+	void search(std::size_t id, UnitPropagator &propagator, BranchingHeuristic &heuristic, SearchStats &stats);
+	void run(std::size_t id);
+
+public:
+	ParallelSearch(std::shared_ptr<const ClauseStore> store, const SearchOptions &options,
+		std::vector<std::uint8_t> &model, SearchStats &stats);
+	bool solve();
+};
+
+ParallelSearch::ParallelSearch(std::shared_ptr<const ClauseStore> store, const SearchOptions &options,
+	std::vector<std::uint8_t> &model, SearchStats &stats)
+	: _store(store), _options(options), _done(false), _idle(0), _satisfiable(false), _model(model), _stats(stats)
+{
+	for(std::size_t i = 0; i < options.threads; ++i)
+		_workers.emplace_back(new Worker());
+}
+
+bool ParallelSearch::steal(std::size_t thief, std::vector<int> &task)
+{
+	for(std::size_t k = 1; k < _workers.size(); ++k)
+	{
+		Worker &victim = *_workers[(thief + k) % _workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		for(std::size_t i = 0; i < victim.decisions.size(); ++i)
+		{
+			if(victim.decisions[i].flipped)
+				continue;
+
+			victim.decisions[i].flipped = true;
+			task.clear();
+			for(std::size_t j = 0; j < i; ++j)
+				task.push_back(victim.decisions[j].literal);
+			task.push_back(-victim.decisions[i].literal);
+
+			// the victim is busy, so the count cannot reach the number of workers in between
+			--_idle;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Searches the subtree below the task's decisions; returns true on a model, false once the subtree is
+// exhausted or the search is cancelled.
+bool ParallelSearch::explore(Worker &self, UnitPropagator &propagator, BranchingHeuristic &heuristic,
+	const std::vector<int> &task, SearchStats &stats)
+{
+	propagator.backtrack(0);
+	heuristic.reset();
+
+	{
+		std::lock_guard<std::mutex> lock(self.mutex);
+		self.decisions.clear();
+		for(int literal : task)
+			self.decisions.emplace_back(literal, true);
+	}
+
+	bool possible = true;
+
+	for(std::size_t i = 0; possible && i < task.size(); ++i)
+		possible = propagator.assign(task[i]);
+
+	while(!_done.load(std::memory_order_relaxed))
+	{
+		if(possible)
+		{
+			int literal = heuristic.pick(propagator);
+
+			if(literal == 0)
+				return true;
+
+			{
+				std::lock_guard<std::mutex> lock(self.mutex);
+				self.decisions.emplace_back(literal);
+			}
+			possible = propagator.assign(literal);
+			++stats.decisions;
+			continue;
+		}
+
+		++stats.conflicts;
+		int literal;
+		std::size_t level;
+
+		{
+			std::lock_guard<std::mutex> lock(self.mutex);
+
+			while(!self.decisions.empty() && self.decisions.back().flipped)
+				self.decisions.pop_back();
+
+			if(self.decisions.empty())
+				return false;
+
+			Decision &decision = self.decisions.back();
+			decision.flipped = true;
+			decision.literal = -decision.literal;
+			literal = decision.literal;
+			level = self.decisions.size() - 1;
+		}
+
+		propagator.backtrack(level);
+		possible = propagator.assign(literal);
+	}
+
+	return false;
+}
+
+// Works on tasks until the search ends.
+void ParallelSearch::search(std::size_t id, UnitPropagator &propagator, BranchingHeuristic &heuristic, SearchStats &stats)
+{
+	Worker &self = *_workers[id];
+	std::vector<int> task;
+	bool has_task = id == 0;
+
+	if(!propagator.propagate())
+	{
+		_done = true;
+		return;
+	}
+
+	while(!_done.load(std::memory_order_relaxed))
+	{
+		if(has_task)
+		{
+			if(explore(self, propagator, heuristic, task, stats))
+			{
+				std::lock_guard<std::mutex> lock(_model_mutex);
+
+				if(!_done)
+				{
+					_satisfiable = true;
+					_model.assign(propagator.numvar() + 1, 0);
+					for(std::size_t i = 1; i <= propagator.numvar(); ++i)
+						_model[i] = propagator.value(i);
+					_done = true;
+				}
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(self.mutex);
+				self.decisions.clear();
+			}
+			has_task = false;
+			++_idle;
+		}
+
+		has_task = steal(id, task);
+
+		if(!has_task)
+		{
+			if(_idle == _workers.size())
+				_done = true;
+			else
+				std::this_thread::yield();
+		}
+	}
+}
+
+void ParallelSearch::run(std::size_t id)
+{
+	UnitPropagator propagator(_store);
+	std::unique_ptr<BranchingHeuristic> heuristic = make_heuristic(_options.heuristic);
+	SearchStats stats;
+
+	if(heuristic->needs_counts())
+		propagator.enable_counts();
+
+	if(_options.pure_literals)
+		propagator.enable_pure_literals();
+
+	search(id, propagator, *heuristic, stats);
+
+	std::lock_guard<std::mutex> lock(_model_mutex);
+	_stats.decisions += stats.decisions;
+	_stats.conflicts += stats.conflicts;
+	_stats.propagations += propagator.propagations();
+}
+
+bool ParallelSearch::solve()
+{
+	std::vector<std::thread> threads;
+
+	// worker 0 starts at the root, everybody else starts out idle and steals from there
+	_idle = _workers.size() - 1;
+	for(std::size_t i = 0; i < _workers.size(); ++i)
+		threads.emplace_back(&ParallelSearch::run, this, i);
+
+	for(std::thread &thread : threads)
+		thread.join();
+
+	return _satisfiable;
+}
+
+}
+
+bool solve_parallel(std::shared_ptr<const ClauseStore> store, const SearchOptions &options,
+	std::vector<std::uint8_t> &model, SearchStats &stats)
+{
+	return ParallelSearch(store, options, model, stats).solve();
+}
+
+bool solve_formula(std::shared_ptr<const ClauseStore> store, const SearchOptions &options,
+	std::vector<std::uint8_t> &model, SearchStats &stats)
+{
+	if(options.threads > 1 && !options.learning)
+		return solve_parallel(store, options, model, stats);
+
+	UnitPropagator propagator(store);
+	bool satisfiable;
+
+	if(options.learning)
+	{
+		VsidsHeuristic heuristic(propagator.numvar());
+
+		propagator.enable_learning();
+		satisfiable = propagator.propagate() && solve_cdcl(propagator, heuristic, stats);
+	}
+	else
+	{
+		std::unique_ptr<BranchingHeuristic> heuristic = make_heuristic(options.heuristic);
+
+		if(heuristic->needs_counts())
+			propagator.enable_counts();
+
+		if(options.pure_literals)
+			propagator.enable_pure_literals();
+
+		satisfiable = propagator.propagate() && solve_sat(propagator, *heuristic, stats);
+	}
+
+	stats.propagations += propagator.propagations();
+
+	if(!satisfiable)
+		return false;
+
+	model.assign(propagator.numvar() + 1, 0);
+	for(std::size_t i = 1; i <= propagator.numvar(); ++i)
+		model[i] = propagator.value(i);
+
+	return true;
+}
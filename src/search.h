@@ -0,0 +1,59 @@
+#ifndef _SEARCH
+#define _SEARCH
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "heuristics.h"
+#include "unit_propagation.h"
+
+// A decision on the search stack; its level is its position in the stack (counting from 1). For a
+// decision flipped by solve_sat, reasons holds the levels the failure of its first branch depended on.
+struct Decision {
+	int literal;
+	bool flipped;
+	std::vector<std::uint32_t> reasons;
+	explicit Decision(int l, bool f = false)
+	{
+		literal = l;
+		flipped = f;
+	}
+};
+
+struct SearchOptions {
+	const char *heuristic;
+	bool pure_literals;
+	std::size_t threads;
+	// conflict-driven clause learning with VSIDS instead of DPLL; ignores the three options above
+	bool learning;
+
+	SearchOptions() : heuristic("order"), pure_literals(false), threads(1), learning(false) {}
+};
+
+// What a search did: decisions taken, conflicts hit, and literals propagated (summed over all workers).
+struct SearchStats {
+	std::uint64_t decisions;
+	std::uint64_t conflicts;
+	std::uint64_t propagations;
+
+	SearchStats() : decisions(0), conflicts(0), propagations(0) {}
+};
+
+// Searches from the propagator's current (propagated, root level) state with conflict-directed
+// backjumping; returns true with every variable assigned if the formula is satisfiable.
+bool solve_sat(UnitPropagator &propagator, BranchingHeuristic &heuristic, SearchStats &stats);
+
+// Searches with clause learning from the propagator's current (propagated, root level) state, which must
+// have learning enabled and no pure literals; returns true with every variable assigned on SAT.
+bool solve_cdcl(UnitPropagator &propagator, VsidsHeuristic &heuristic, SearchStats &stats);
+
+// Searches with options.threads work-stealing workers sharing the clause store.
+bool solve_parallel(std::shared_ptr<const ClauseStore> store, const SearchOptions &options, std::vector<std::uint8_t> &model, SearchStats &stats);
+
+// Solves the formula as configured by options; on SAT model[v] holds the value of variable v.
+bool solve_formula(std::shared_ptr<const ClauseStore> store, const SearchOptions &options, std::vector<std::uint8_t> &model, SearchStats &stats);
+
+
+#endif
@@ -23,14 +23,15 @@ Fifth Floor, Boston, MA  02110-1301  USA
 
 #ifndef _CNF
 #define _CNF
+#include "cnf/dimacs.h"
 
 struct Cnf{
 	unsigned vc;	// var count
 	unsigned cc;	// clause count
-	int **clauses;	// 2-dim. array with entries same as in cnf file
 	unsigned lc;	// literal count
-	unsigned *cl;	// clause length
+	DimacsFormula formula;	// clauses back to back, as read by read_dimacs
+	const int *clause(unsigned i) const { return formula.literals.data() + formula.offsets[i]; }
+	unsigned length(unsigned i) const { return formula.offsets[i + 1] - formula.offsets[i]; }
 	Cnf(char *fname);
-	~Cnf();
 };
 #endif
@@ -26,6 +26,19 @@ Fifth Floor, Boston, MA  02110-1301  USA
 #include <set>
 #include <algorithm>
 #include "CnfManager.h"
+#ifdef _MSC_VER
+#include <ctime>
+static double _get_wall_time(){
+	return (double) clock() / CLOCKS_PER_SEC;
+}
+#else
+#include <time.h>
+static double _get_wall_time(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+#endif
 
 #ifdef UPDEBUG 
 	#define DB(x) x
@@ -36,73 +49,101 @@ Fifth Floor, Boston, MA  02110-1301  USA
 CnfManager::CnfManager(Cnf &cnf){
 	vars = new Variable[(vc = cnf.vc) + 1];
 	dLevel = 1;
-	nDecisions = nConflicts = nRestarts = 0; 
+	nDecisions = nConflicts = nRestarts = nReductions = 0; 
+	nPropagations = nDeleted = 0;
+	analysisTime = 0;
+	conflictLits = (int *) calloc(vc + 1, sizeof(int));
+	tmpConflictLits = (int *) calloc(vc + 1, sizeof(int));
+	levelStamp = (unsigned *) calloc(vc + 2, sizeof(unsigned));
+	stamp = 0;
 	varOrder = (unsigned *) calloc(vc + 1, sizeof(unsigned));
 	varPosition = (unsigned *) calloc(vc + 1, sizeof(unsigned));
 	int *zero = stackTop = (int *) calloc(vc + 1, sizeof(int));
 
-	// implication lists in lieu of watch lists for binary clauses
-	// temporary storage
-	vector<vector<int> > imp[2];	
-	imp[0].resize(vc + 1);
-	imp[1].resize(vc + 1);
-
 	// mark bottom of stack with variable 0
 	vars[*(stackTop++) = 0].dLevel = 0;
 	vars[0].value = _FREE;
 
+	// first pass: count occurrences, binary clauses and watches per literal
+	// (in a compact array, as the variables are too large to count in)
+	// so that everything below is allocated once and filled in place
+	unsigned i, j;
+	struct LitCount{ unsigned occ, imp, watch; };
+	LitCount *count = (LitCount *) calloc(2 * (vc + 1), sizeof(LitCount));
+	unsigned impPoolSize = 0;
+	for(i = 0; i < cnf.cc; i++){
+		const int *clause = cnf.clause(i);
+		unsigned length = cnf.length(i);
+		if(length < 2) continue;
+		for(j = 0; j < length; j++) count[2 * VAR(clause[j]) + SIGN(clause[j])].occ++;
+		if(length == 2){
+			count[2 * VAR(clause[0]) + SIGN(clause[0])].imp++;
+			count[2 * VAR(clause[1]) + SIGN(clause[1])].imp++;
+			impPoolSize += 2;
+		}else{
+			count[2 * VAR(clause[0]) + SIGN(clause[0])].watch++;
+			count[2 * VAR(clause[1]) + SIGN(clause[1])].watch++;
+		}
+	}
+
+	// binary clause implication lists, back to back in impPool
+	// last element is 0
+	// first three elements are ([], lit, 0)
+	// serve as antecedent for all implications
+	// serve as conflicting clause with [] filled
+	int *q = impPool = (int *) calloc(impPoolSize + 4 * 2 * vc, sizeof(int));
+	for(i = 1; i <= vc; i++) for(j = 0; j <= 1; j++){
+		LitCount &c = count[2 * i + j];
+		vars[i].activity[j] = c.occ;
+		vars[i].imp[j] = q;
+		q[1] = i * ((j == _POSI)?1:-1);
+		q += c.imp + 4;
+		c.imp = 3;			// now the next free slot
+		vars[i].watch[j].reserve(c.watch);
+	}
+
 	// create litPool
-	int *p = litPool = (int *) calloc(litPoolCapacity = (cnf.lc + cnf.cc) * 2, sizeof(int));
-	if(litPool == NULL){
+	int *p = litPool = (int *) calloc(litPoolCapacityOrig = litPoolCapacity = (cnf.lc + cnf.cc) * 2, sizeof(int));
+	if(litPool == NULL || impPool == NULL){
 		fprintf(stderr, "Unable to allocate %lu bytes of memory\n", (long unsigned) litPoolCapacity * sizeof(int));
 		printf("s UNKOWN\n");
 		exit(0);
 	}
 	litPools.push_back(litPool);
 
-	// populate litPool
-	unsigned i, j;
+	// second pass: populate litPool and the implication lists
 	for(i = 0; i < cnf.cc; i++){
-		if(cnf.clauses[i][1] == 0){		// unit clause
-			int lit = cnf.clauses[i][0];
+		const int *clause = cnf.clause(i);
+		unsigned length = cnf.length(i);
+		if(length == 0){			// empty clause
+			printf("c empty clause\n");
+			printf("s UNSATISFIABLE\n");
+			exit(20);
+		}else if(length == 1){			// unit clause
+			int lit = clause[0];
 			if(FREE(lit)) setLiteral(*(stackTop++) = lit, zero);
 			else if(RESOLVED(lit)){
 				printf("c contradictory unit clauses %d, %d\n", lit, -lit);
 				printf("s UNSATISFIABLE\n");
 				exit(20);
 			}
-		}else if(cnf.clauses[i][2] == 0){	// binary clause
-			int lit0 = cnf.clauses[i][0];
-			int lit1 = cnf.clauses[i][1];
-			imp[SIGN(lit0)][VAR(lit0)].push_back(lit1);
-			imp[SIGN(lit1)][VAR(lit1)].push_back(lit0);
-			vars[VAR(lit0)].activity[SIGN(lit0)]++;
-			vars[VAR(lit1)].activity[SIGN(lit1)]++;
+		}else if(length == 2){			// binary clause
+			int lit0 = clause[0];
+			int lit1 = clause[1];
+			IMPLIST(lit0)[count[2 * VAR(lit0) + SIGN(lit0)].imp++] = lit1;
+			IMPLIST(lit1)[count[2 * VAR(lit1) + SIGN(lit1)].imp++] = lit0;
 		}else{
 			// set up watches
-			WATCHLIST(cnf.clauses[i][0]).push_back(p);
-			WATCHLIST(cnf.clauses[i][1]).push_back(p);
+			WATCHLIST(clause[0]).push_back(Watch(p, clause[1]));
+			WATCHLIST(clause[1]).push_back(Watch(p, clause[0]));
 
-			// copy literals to litPool
-			for(j = 0; (*(p++) = cnf.clauses[i][j]); j++){
-				vars[VAR(*(p-1))].activity[SIGN(*(p-1))]++;
-			}
+			// copy literals to litPool, zero-terminated
+			for(j = 0; j < length; j++) *(p++) = clause[j];
+			*(p++) = 0;
 		}
 	}
 	litPoolSize = litPoolSizeOrig = (p - litPool); 
-	
-	// binary clause implication lists
-	for(i = 1; i <= vc; i++) for(j = 0; j <= 1; j++){
-		// last element is 0
-		// first three elements are ([], lit, 0)
-		// serve as antecedent for all implications
-		// serve as conflicting clause with [] filled
-		vars[i].imp[j] = (int *) calloc(imp[j][i].size() + 4, sizeof(int));
-		vars[i].imp[j][1] = i * ((j == _POSI)?1:-1);
-		unsigned k = 3;
-		for(vector<int>::iterator it = imp[j][i].begin(); it != imp[j][i].end(); it++)
-			vars[i].imp[j][k++] = *it;
-	}
+	free(count);
 
 	// assert unit clauses
 	assertUnitClauses();
@@ -111,7 +152,8 @@ CnfManager::CnfManager(Cnf &cnf){
 CnfManager::~CnfManager(){
 	for(vector<int *>::iterator it = litPools.begin(); it != litPools.end(); free(*(it++)));
 	while(*(--stackTop)); free(stackTop);
-	for(unsigned i = 1; i <= vc; i++) for(unsigned j = 0; j <= 1; j++) free(vars[i].imp[j]);
+	free(impPool); free(levelStamp);
+	free(conflictLits); free(tmpConflictLits);
 	free(varOrder); free(varPosition); delete [] vars;
 }
 
@@ -141,6 +183,7 @@ bool CnfManager::assertLiteral(int lit, int *ante){
 	while(stackTop < newStackTop){
 		// the literal resolved (as opposed to set)
 		int lit = NEG(*(stackTop++));	
+		nPropagations++;
 
 		// implications via binary clauses
 		int *impList = IMPLIST(lit);
@@ -162,15 +205,18 @@ bool CnfManager::assertLiteral(int lit, int *ante){
 		}
 
 		// other implications
-		vector<int *> &watchList = WATCHLIST(lit);
-		for(vector<int *>::iterator it = watchList.begin(); it != watchList.end(); it++){
+		vector<Watch> &watchList = WATCHLIST(lit);
+		for(vector<Watch>::iterator it = watchList.begin(); it != watchList.end(); it++){
+			// blocker set, clause satisfied without looking at it
+			if(SET(it->blocker)) continue;
+
 			// identify the two watched literals
-			int *first = *it, *watch, *otherWatch;
+			int *first = it->clause, *watch, *otherWatch;
 			if(*first == lit){ watch = first; otherWatch = first + 1; }
 			else{ watch = first + 1; otherWatch = first; }
 
 			// clause satisfied, no need to check further
-			if(SET(*otherWatch)) continue;
+			if(SET(*otherWatch)){ it->blocker = *otherWatch; continue; }
 
 			// look for free/true literal
 			int *p = first + 2;
@@ -181,7 +227,7 @@ bool CnfManager::assertLiteral(int lit, int *ante){
 			// free/true literal found, swap
 			if(found){
 				// watch p
-				WATCHLIST(*p).push_back(first);
+				WATCHLIST(*p).push_back(Watch(first, *otherWatch));
 
 				// unwatch watch
 				*(it--) = watchList.back();
@@ -219,21 +265,22 @@ bool CnfManager::assertLiteral(int lit, int *ante){
 void CnfManager::learnClause(int *first){
 	// contradiction in level 1, instance unsat
 	if(dLevel == 1){ aLevel = 0; return; }
+	double startTime = _get_wall_time();
 
 	// update var scores and positions
 	updateScores(first);
 
 	// clear temporary storage
-	conflictLits.clear();
+	conflictSize = tmpConflictSize = 0;
 	unsigned curLevelLits = 0;
 
 	// mark all literals in conflicting clause
 	// push to tmpConflictLits those set prior to current dLevel
-	for(tmpConflictLits.clear(); *first; first++){
+	for(; *first; first++){
 		// drop known backbone literals
 		if(vars[VAR(*first)].dLevel == 1) continue;
 
-		if(vars[VAR(*first)].dLevel < dLevel) tmpConflictLits.push_back(*first);
+		if(vars[VAR(*first)].dLevel < dLevel) tmpConflictLits[tmpConflictSize++] = *first;
 		else curLevelLits++;
 		vars[VAR(*first)].mark = true;
 	}
@@ -264,7 +311,7 @@ void CnfManager::learnClause(int *first){
 		// else, replace with antecedent (resolution)
 		for(int *ante = vars[var].ante; *ante; ante++){
 			if(vars[VAR(*ante)].mark || vars[VAR(*ante)].dLevel == 1) continue;
-			if(vars[VAR(*ante)].dLevel < dLevel) tmpConflictLits.push_back(*ante);
+			if(vars[VAR(*ante)].dLevel < dLevel) tmpConflictLits[tmpConflictSize++] = *ante;
 			else curLevelLits++;
 			vars[VAR(*ante)].mark = true;
 		}
@@ -272,75 +319,91 @@ void CnfManager::learnClause(int *first){
 
 	// conflict clause minimization
 	// compute assertion level (aLevel) 
-	// make sure front of conflictLits is a literal from assertion level
+	// swap a literal from assertion level to front of conflictLits
 	aLevel = 1; 
-	deque<int>::iterator it;
-	for(it = tmpConflictLits.begin(); it != tmpConflictLits.end(); it++){
+	unsigned i;
+	for(i = 0; i < tmpConflictSize; i++){
+		int x = tmpConflictLits[i];
 		bool redundant = true;
-		int *ante = vars[VAR(*it)].ante;
+		int *ante = vars[VAR(x)].ante;
 		if(ante == NULL) redundant = false;
 		else for(; *ante; ante++) if(!vars[VAR(*ante)].mark){ redundant = false; break; }
 		if(!redundant){
-			if(vars[VAR(*it)].dLevel > aLevel){
-			       	aLevel = vars[VAR(*it)].dLevel;	
-		       		conflictLits.push_front(*it);
-			}else conflictLits.push_back(*it);
+			conflictLits[conflictSize] = x;
+			if(vars[VAR(x)].dLevel > aLevel){
+				aLevel = vars[VAR(x)].dLevel;
+				conflictLits[conflictSize] = conflictLits[0];
+				conflictLits[0] = x;
+			}
+			conflictSize++;
 		}
 	}
 
 	// clear variable marks
-	for(it = tmpConflictLits.begin(); it != tmpConflictLits.end(); it++)
-		vars[VAR(*it)].mark = false;
+	for(i = 0; i < tmpConflictSize; i++)
+		vars[VAR(tmpConflictLits[i])].mark = false;
 
 	// unique lit from current dLevel pushed last
-	conflictLits.push_back(-lit);
+	conflictLits[conflictSize++] = -lit;
 
 	// add clause to litPool and set up watches
 	addClause();
 
 	DB(	printf("   [aLevel: %d]", aLevel);
-		for(deque<int>::iterator it = conflictLits.begin(); it != conflictLits.end(); it++)
-			printf(" %d", *it);
+		for(i = 0; i < conflictSize; i++)
+			printf(" %d", conflictLits[i]);
 		printf("\n");
 	)
+	analysisTime += _get_wall_time() - startTime;
+}
+
+void CnfManager::reserveLitPool(unsigned size){
+	if(litPoolSize + size <= litPoolCapacity) return;
+	litPoolCapacity *= 2;
+	litPool = (int *) malloc(litPoolCapacity * sizeof(int));
+	while(litPool == NULL && litPoolCapacity > litPoolSizeOrig){
+		litPoolCapacity /= 2;
+		litPool = (int *) malloc(litPoolCapacity * sizeof(int));
+	}
+	if(litPool == NULL){
+		printf("c unable to allocate %lu bytes of memory\n", (long unsigned) litPoolCapacity * sizeof(int));
+		printf("s UNKOWN\n");
+		exit(0);
+	}
+	litPools.push_back(litPool);
+	litPoolSize = 0;
 }
 
 inline void CnfManager::addClause(){
-	unsigned size = conflictLits.size();
+	unsigned size = conflictSize;
 
 	// create new litPool if necessary
-	if(litPoolSize + size + 1 > litPoolCapacity){
-		litPoolCapacity *= 2;
-		litPool = (int *) malloc(litPoolCapacity * sizeof(int));
-		while(litPool == NULL && litPoolCapacity > litPoolSizeOrig){
-			litPoolCapacity /= 2;
-			litPool = (int *) malloc(litPoolCapacity * sizeof(int));
-		}
-		if(litPool == NULL){
-			printf("c unable to allocate %lu bytes of memory\n", (long unsigned) litPoolCapacity * sizeof(int));
-			printf("s UNKOWN\n");
-			exit(0);
-		}
-		litPools.push_back(litPool);
-		litPoolSize = 0;
-	}
+	reserveLitPool(size + 1);
 	
 	// clause starts here
 	conflictClause = litPool + litPoolSize;
 
 	// first literal is the unique literal from current level
-	litPool[litPoolSize++] = conflictLits.back();
+	litPool[litPoolSize++] = conflictLits[size - 1];
 
 	if(size > 1){
 		// add clause to list
 		clauses.push_back(conflictClause);
 
+		// LBD: number of distinct dLevels among its literals
+		unsigned lbd = 0; stamp++;
+		for(unsigned i = 0; i < size; i++){
+			unsigned level = vars[VAR(conflictLits[i])].dLevel;
+			if(levelStamp[level] != stamp){ levelStamp[level] = stamp; lbd++; }
+		}
+		lbds.push_back(lbd);
+
 		// second literal is one from assertion level
-		litPool[litPoolSize++] = conflictLits.front();
+		litPool[litPoolSize++] = conflictLits[0];
 
 		// set up 2 watches
-		WATCHLIST(conflictLits.back()).push_back(conflictClause);
-		WATCHLIST(conflictLits.front()).push_back(conflictClause);
+		WATCHLIST(conflictLits[size - 1]).push_back(Watch(conflictClause, conflictLits[0]));
+		WATCHLIST(conflictLits[0]).push_back(Watch(conflictClause, conflictLits[size - 1]));
 		
 		// copy rest of literals to litPool
 		for(unsigned i = 1; i < size - 1;) litPool[litPoolSize++] = conflictLits[i++];
@@ -350,6 +413,90 @@ inline void CnfManager::addClause(){
 	litPool[litPoolSize++] = 0;
 }
 
+struct compLbds{
+	const vector<unsigned> &lbds;
+	compLbds(const vector<unsigned> &myLbds) : lbds(myLbds) {}
+	bool operator()(unsigned a, unsigned b) const{ 
+		// lower LBD first, newer clause first among equals
+		return lbds[a] < lbds[b] || (lbds[a] == lbds[b] && a > b); 
+	}
+};
+
+// deletes the conflict clauses satisfied in dLevel 1 and the worse half of the others by LBD,
+// but never those of LBD 2 or less nor antecedents; the clauses kept are copied back behind
+// the original clauses in their order, and watched again by their first two literals
+// must be called in dLevel 1 with no conflict clause waiting to be asserted
+void CnfManager::reduceClauses(){
+	unsigned i, j;
+	vector<char> keep(clauses.size(), 0);
+	vector<unsigned> order;
+	for(i = 0; i < clauses.size(); i++){
+		int *p = clauses[i];
+		if(!FREE(*p) && vars[VAR(*p)].ante == p + 1){ keep[i] = 1; continue; }
+		for(; *p; p++) if(SET(*p)) break;
+		if(*p == 0) order.push_back(i);
+	}
+	sort(order.begin(), order.end(), compLbds(lbds));
+	for(i = 0; i < order.size(); i++)
+		if(i < order.size() / 2 || lbds[order[i]] <= 2) keep[order[i]] = 1;
+
+	// set the clauses kept aside, antecedents marked by a negative LBD
+	vector<int> kept;
+	vector<int> keptLbds;
+	for(i = 0; i < clauses.size(); i++){
+		if(!keep[i]){ nDeleted++; continue; }
+		int *p = clauses[i];
+		bool ante = !FREE(*p) && vars[VAR(*p)].ante == p + 1;
+		keptLbds.push_back(ante ? -(int) lbds[i] : (int) lbds[i]);
+		for(; *p; p++) kept.push_back(*p);
+		kept.push_back(0);
+	}
+
+	// antecedents in dLevel 1 are never looked at again, but must not point into freed memory:
+	// unit conflict clauses give way to the empty clause at the bottom of the stack
+	// (antecedents among the clauses kept are moved along below)
+	int *bottom = stackTop - 1;
+	while(*bottom) bottom--;
+	for(int *p = stackTop - 1; p > bottom; p--){
+		int *&ante = vars[VAR(*p)].ante;
+		if(ante != NULL && *ante == 0) ante = bottom;
+	}
+
+	// only watches of original clauses remain
+	int *origBegin = litPools[0], *origEnd = litPools[0] + litPoolSizeOrig;
+	for(i = 1; i <= vc; i++) for(j = 0; j <= 1; j++){
+		vector<Watch> &watchList = vars[i].watch[j];
+		unsigned k = 0;
+		for(unsigned l = 0; l < watchList.size(); l++)
+			if(watchList[l].clause >= origBegin && watchList[l].clause < origEnd) watchList[k++] = watchList[l];
+		watchList.erase(watchList.begin() + k, watchList.end());
+	}
+
+	// retire all litPools but the first
+	for(i = 1; i < litPools.size(); i++) free(litPools[i]);
+	litPools.resize(1);
+	litPool = litPools[0];
+	litPoolSize = litPoolSizeOrig;
+	litPoolCapacity = litPoolCapacityOrig;
+
+	// copy the clauses kept back
+	clauses.clear(); lbds.clear();
+	for(i = j = 0; i < keptLbds.size(); i++){
+		unsigned size = 0;
+		while(kept[j + size]) size++;
+		reserveLitPool(size + 1);
+		int *clause = litPool + litPoolSize;
+		for(unsigned k = 0; k <= size; k++) litPool[litPoolSize++] = kept[j++];
+
+		clauses.push_back(clause);
+		lbds.push_back(keptLbds[i] < 0 ? -keptLbds[i] : keptLbds[i]);
+		if(keptLbds[i] < 0) vars[VAR(*clause)].ante = clause + 1;
+		WATCHLIST(clause[0]).push_back(Watch(clause, clause[1]));
+		WATCHLIST(clause[1]).push_back(Watch(clause, clause[0]));
+	}
+	nReductions++;
+}
+
 void CnfManager::updateScores(int *p){
 	for(; *p; p++){
 		unsigned v = VAR(*p);
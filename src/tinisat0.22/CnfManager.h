@@ -24,7 +24,6 @@ Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef _CNF_MANAGER
 #define _CNF_MANAGER
 #include <vector>
-#include <deque>
 #include "Cnf.h"
 using namespace std;
 
@@ -43,6 +42,12 @@ using namespace std;
 #define WATCHLIST(lit) 	(vars[VAR(lit)].watch[SIGN(lit)]) 
 #define SCORE(var)	(vars[(var)].activity[0]+vars[(var)].activity[1])
 
+struct Watch{
+	int *clause;			// clause watching the literal
+	int blocker;			// some other literal of clause; if set, clause is satisfied
+	Watch(int *myClause, int myBlocker): clause(myClause), blocker(myBlocker) {}
+};
+
 struct Variable{
 	bool mark;			// used in 1-UIP derivation
 	bool phase;			// suggested phase for decision
@@ -51,7 +56,7 @@ struct Variable{
 	int *ante;			// antecedent clause if implied
 	unsigned activity[2];		// scores for literals
 	int *imp[2];			// implication lists for binary clauses
-	vector<int *> watch[2];		// watch lists for other clauses
+	vector<Watch> watch[2];		// watch lists for other clauses
 	Variable(): mark(false), value(_FREE){
 	 	activity[0] = activity[1] = 0; 
 		watch[0].clear(); watch[1].clear();
@@ -66,12 +71,17 @@ protected:
 	unsigned *varPosition;		// variable position in varOrder
 	unsigned nextVar;		// starting point in varOrder
 
+	int *impPool;			// implication lists of all literals
 	int *litPool; 			// array of literals as in clauses
 	unsigned litPoolSize; 		// literal pool size
 	unsigned litPoolSizeOrig; 	// original clauses only
 	unsigned litPoolCapacity;	// capacity of current litPool
+	unsigned litPoolCapacityOrig;	// capacity of litPools[0], holding the original clauses
 	vector<int *> litPools;		// all litPools created
 	vector<int *> clauses;		// array of conflict clauses 
+	vector<unsigned> lbds;		// LBD of each conflict clause when learned
+	unsigned *levelStamp;		// used in LBD computation
+	unsigned stamp;			// ditto
 	int nextClause; 		// starting point to look for unsatisfied conflict clause	
 
 	int *stackTop; 			// decision/implication stack
@@ -80,8 +90,14 @@ protected:
 	unsigned nDecisions; 		// num of decisions
 	unsigned nConflicts;		// num of conflicts
 	unsigned nRestarts;		// num of restarts
-	deque<int> conflictLits;	// stores conflict literals
-	deque<int> tmpConflictLits;	// ditto, temporary
+	unsigned nReductions;		// num of clause deletion rounds
+	unsigned long long nDeleted;	// num of conflict clauses deleted
+	unsigned long long nPropagations;	// num of literals resolved
+	double analysisTime;		// time spent in learnClause
+	int *conflictLits;		// stores conflict literals, vc at most
+	unsigned conflictSize;		// num of conflict literals
+	int *tmpConflictLits;		// ditto, temporary
+	unsigned tmpConflictSize;	// ditto
 	int *conflictClause;		// points to learned clause in litPool 
 
 	void setLiteral(int lit, int *ante);	// set value, ante, level 
@@ -90,6 +106,8 @@ protected:
 	bool decide(int lit);			// increment dLevel and call assertLitreal
 	void learnClause(int *firstLit);	// store learned clause in conflictLits and call addClause
 	void addClause();			// add conflictLits to litPool and set up watches
+	void reserveLitPool(unsigned size);	// make room for size literals, in a new litPool if necessary
+	void reduceClauses();			// delete conflict clauses and compact litPool, in dLevel 1
 	bool assertCL();			// assert literal implied by conflict clause
 	void backtrack(unsigned level);		// undo assignments in levels > level 
 	void scoreDecay();			// divide scores by constant
@@ -43,6 +43,7 @@ SatSolver::SatSolver(Cnf &cnf): CnfManager(cnf){
 	// initialize parameters 
 	nextRestart = luby.next() * (lubyUnit = 512);
 	nextDecay = HALFLIFE;
+	maxLearnts = max(cnf.cc / 3, (unsigned) 10000);
 
 	// assertUnitClauses has failed
 	if(dLevel == 0) return; 
@@ -130,7 +131,15 @@ bool SatSolver::run(){
 				nRestarts++;
 				nextRestart += luby.next() * lubyUnit;
 				backtrack(1);
-				if(dLevel != aLevel) break;
+				if(dLevel != aLevel){
+					// no conflict clause to assert, delete some
+					if(clauses.size() >= maxLearnts){
+						reduceClauses();
+						maxLearnts += maxLearnts / 10;
+						nextClause = clauses.size() - 1;
+					}
+					break;
+				}
 
 			// partial restart at aLevel 
 			}else backtrack(aLevel);
@@ -162,5 +171,7 @@ void SatSolver::printSolution(FILE *ofp){
 }
 
 void SatSolver::printStats(){
-	printf("c %d decisions, %d conflicts, %d restarts\n", nDecisions, nConflicts, nRestarts);
+	printf("c %d decisions, %d conflicts, %d restarts, %llu propagations\n", nDecisions, nConflicts, nRestarts, nPropagations);
+	printf("c %d reductions, %llu conflict clauses deleted\n", nReductions, nDeleted);
+	printf("c %.2fs in conflict analysis, %.2fus per conflict\n", analysisTime, nConflicts ? analysisTime * 1e6 / nConflicts : 0.0);
 }
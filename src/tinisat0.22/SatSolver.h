@@ -45,6 +45,7 @@ class SatSolver: public CnfManager{
 	unsigned lubyUnit;	// unit run length for Luby's
 	unsigned nextDecay;	// next score decay point
 	unsigned nextRestart;	// next restart point
+	unsigned maxLearnts;	// num of conflict clauses triggering deletion
 
 	int selectLiteral();
 	bool verifySolution();
@@ -1,154 +1,906 @@
 #include <algorithm>
-#include <cmath>
-#include <cstdio>
-#include <cstring>
-#include <queue>
-#include <stack>
-#include <tuple>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "cnf/dimacs.h"
 #include "unit_propagation.h"
-#include "sat_utils.h"
 
 /**
  * Implementation of a linear unit propagation described in this paper:
  * http://www.cfdvs.iitb.ac.in/download/Docs/verification/papers/sat/original-papers/aim96.pdf
  * working in amortized linear time for true assignments and amortized constant time for false assignments.
+ *
+ * The propagator is persistent: the clause database and the head/tail lists are built once and every
+ * move of a head or tail index is recorded on an undo trail. A clause is pushed onto the list of its new
+ * head (tail) literal and never removed from the old one, so undoing a move only needs to restore the index
+ * and pop the clause back off the list it was pushed onto, which is always its last element.
+ *
+ * The clauses themselves live in a read-only ClauseStore that several propagators may share, and head/tail
+ * indices are positions in its literal array. Head (tail) lists are indexed by literal (2 * variable + sign).
+ * The head can only ever stand on each position once between backtracks, so a list never holds more
+ * clauses than its literal has occurrences and every list fits a fixed segment of a single arena.
+ *
+ * Each clause kind has arenas of its own, so that propagation picks the kernel once per list rather than
+ * once per clause. A binary clause has nowhere to move its head or tail to, so it needs no lists at all:
+ * the store keeps it as an implication on each of its two literals.
  */
 
+ClauseStore::ClauseStore(const std::vector<std::vector<int>> &clauses, std::size_t n)
+{
+	std::size_t numlit = 0;
+
+	numvar = n;
+	for (const std::vector<int> &clause : clauses)
+		numlit += clause.size();
+	literals.reserve(numlit);
+	offsets.reserve(clauses.size() + 1);
+	offsets.push_back(0);
+
+	for (const std::vector<int> &clause : clauses)
+	{
+		literals.insert(literals.end(), clause.begin(), clause.end());
+		offsets.push_back(static_cast<std::uint32_t>(literals.size()));
+	}
+
+	build();
+}
+
+ClauseStore::ClauseStore(std::vector<int> l, std::vector<std::uint32_t> o, std::size_t n)
+	: numvar(n), literals(std::move(l)), offsets(std::move(o))
+{
+	build();
+}
+
+// Compacts the clauses in place (see remove_redundancy), then groups the occurrences by literal.
+void ClauseStore::build()
+{
+	remove_redundancy(numvar, literals, offsets);
+
+	occurrence_start.assign(2 * numvar + 3, 0);
+	for (int literal : literals)
+		++occurrence_start[literal_index(literal) + 1];
+	for (std::size_t lit = 0; lit + 1 < occurrence_start.size(); ++lit)
+		occurrence_start[lit + 1] += occurrence_start[lit];
+
+	std::vector<std::uint32_t> fill(occurrence_start.begin(), occurrence_start.end() - 1);
+	occurrences.resize(literals.size());
+	for (std::uint32_t clause_id = 0; clause_id < size(); ++clause_id)
+		for (std::uint32_t i = offsets[clause_id]; i < offsets[clause_id + 1]; ++i)
+			occurrences[fill[literal_index(literals[i])]++] = clause_id;
+
+	implication_start.assign(occurrence_start.size(), 0);
+	ternary_start.assign(occurrence_start.size(), 0);
+	long_start.assign(occurrence_start.size(), 0);
+	auto kind_start = [this](std::uint32_t clause_id) -> std::vector<std::uint32_t> & {
+		switch (clause_kind(offsets[clause_id + 1] - offsets[clause_id]))
+		{
+		case binary_clause: return implication_start;
+		case ternary_clause: return ternary_start;
+		default: return long_start;
+		}
+	};
+	for (std::uint32_t clause_id = 0; clause_id < size(); ++clause_id)
+	{
+		std::vector<std::uint32_t> &start = kind_start(clause_id);
+		for (std::uint32_t i = offsets[clause_id]; i < offsets[clause_id + 1]; ++i)
+			++start[literal_index(literals[i]) + 1];
+	}
+	for (std::size_t lit = 0; lit + 1 < occurrence_start.size(); ++lit)
+	{
+		implication_start[lit + 1] += implication_start[lit];
+		ternary_start[lit + 1] += ternary_start[lit];
+		long_start[lit + 1] += long_start[lit];
+	}
+
+	fill.assign(implication_start.begin(), implication_start.end() - 1);
+	implications.resize(implication_start.back());
+	for (std::uint32_t clause_id = 0; clause_id < size(); ++clause_id)
+		if (offsets[clause_id + 1] - offsets[clause_id] == 2)
+		{
+			int first = literals[offsets[clause_id]];
+			int second = literals[offsets[clause_id] + 1];
+			implications[fill[literal_index(first)]++] = { second, clause_id };
+			implications[fill[literal_index(second)]++] = { first, clause_id };
+		}
+}
+
+// The segment of a literal in a head (tail) arena is where its occurrences of the kind start in the store.
+static void layout_arena(OccurrenceArena &arena, const std::vector<std::uint32_t> &start)
+{
+	arena.start = start.data();
+	arena.size.assign(start.size() - 1, 0);
+	arena.clauses.resize(start.back());
+}
+
+const std::uint32_t UnitPropagator::decision_reason;
+const std::uint32_t UnitPropagator::pure_reason;
+
 UnitPropagator::UnitPropagator(const std::vector<std::vector<int>> &clauses, std::size_t numvar)
+	: UnitPropagator(std::make_shared<const ClauseStore>(clauses, numvar))
+{
+}
+
+UnitPropagator::UnitPropagator(std::shared_ptr<const ClauseStore> store)
+	: _store(store), _literals(store->literals), _offsets(store->offsets),
+	_occurrences(store->occurrences), _occurrence_start(store->occurrence_start),
+	_implications(store->implications), _implication_start(store->implication_start)
 {
-	_clauses = clauses;
-	_numvar = numvar;
-	_is_defined = std::vector<bool>(numvar, false);
-	_value = std::vector<bool>(numvar, false);
+	std::size_t numclause = store->size();
+
+	_numvar = store->numvar;
+	_is_defined.assign(_numvar + 1, 0);
+	_value.assign(_numvar + 1, 0);
+	_level.assign(_numvar + 1, 0);
+	_reason.assign(_numvar + 1, decision_reason);
+	_seen.assign(_numvar + 1, 0);
+	_conflict_clause = decision_reason;
 	_OK = true;
-	_clauses_of_pos_head = std::vector<std::vector<int>>(numvar, std::vector<int>());
-	_clauses_of_neg_head = std::vector<std::vector<int>>(numvar, std::vector<int>());
-	_clauses_of_pos_tail = std::vector<std::vector<int>>(numvar, std::vector<int>());
-	_clauses_of_neg_tail = std::vector<std::vector<int>>(numvar, std::vector<int>());
+	_counting = false;
+	_pure_literals = false;
+	_learning = false;
+	_numclause = static_cast<std::uint32_t>(numclause);
+	_queue_head = 0;
+	_propagations = 0;
+
+	_head_index.reserve(numclause);
+	_tail_index.reserve(numclause);
+	layout_arena(_ternary_heads, store->ternary_start);
+	layout_arena(_ternary_tails, store->ternary_start);
+	layout_arena(_long_heads, store->long_start);
+	layout_arena(_long_tails, store->long_start);
 
-	_head_index = std::vector<int>(_clauses.size(), 0);
-	for (int i = 0; i < _clauses.size(); ++i)
-		_tail_index.push_back((int)(_clauses[i].end() - _clauses[i].begin()) - 1);
+	for (std::uint32_t clause_id = 0; clause_id < numclause; ++clause_id)
+	{
+		std::uint32_t head = _offsets[clause_id];
+		std::uint32_t end = _offsets[clause_id + 1];
+
+		_head_index.push_back(head);
+		_tail_index.push_back(head == end ? head : end - 1);
+
+		// binary clauses are propagated through the implications of the store alone
+		if (head == end)
+			_OK = false;
+		else if (end - head == 1)
+		{
+			_long_heads.push(index(_literals[head]), clause_id);
+			if (!enqueue(_literals[head], clause_id))
+				_OK = false;
+		}
+		else if (end - head == 3)
+		{
+			_ternary_heads.push(index(_literals[head]), clause_id);
+			_ternary_tails.push(index(_literals[end - 1]), clause_id);
+		}
+		else if (end - head > 3)
+		{
+			_long_heads.push(index(_literals[head]), clause_id);
+			_long_tails.push(index(_literals[end - 1]), clause_id);
+		}
+	}
 }
 
-void UnitPropagator::insert_clause_head_list(int clause_id, int literal)
+bool UnitPropagator::enqueue(int literal, std::uint32_t reason)
 {
-	if (literal > 0)
-		_clauses_of_pos_head[std::abs(literal)].push_back(clause_id);
-	else
-		_clauses_of_neg_head[std::abs(literal)].push_back(clause_id);
+	std::size_t var = variable(literal);
+	if (_is_defined[var])
+	{
+		if (!is_true(literal))
+			_conflict_clause = reason;
+		return is_true(literal);
+	}
+
+	_is_defined[var] = 1;
+	_value[var] = literal > 0;
+	_level[var] = static_cast<std::uint32_t>(decision_level());
+	_reason[var] = reason;
+	_trail.push_back(literal);
+	if (_counting)
+		count_assignment(literal);
+	return true;
 }
 
-void UnitPropagator::insert_clause_tail_list(int clause_id, int literal)
+/**
+ * Occurrence counting. Every clause keeps the number of its true and of its free literals; a clause is
+ * unresolved while it has no true literal. The counts are updated eagerly through full occurrence lists
+ * on every assignment, and the updates are mirrored exactly when the trail is unwound.
+ */
+
+void UnitPropagator::enable_counts()
 {
-	if (literal > 0)
-		_clauses_of_pos_tail[std::abs(literal)].push_back(clause_id);
-	else
-		_clauses_of_neg_tail[std::abs(literal)].push_back(clause_id);
+	if (_counting)
+		return;
+
+	std::size_t numclause = _offsets.size() - 1;
+	std::size_t numlit = 2 * _numvar + 2;
+
+	_true_count.assign(numclause, 0);
+	_free_count.resize(numclause);
+	_live_count.assign(numlit, 0);
+	_binary_count.assign(numlit, 0);
+	_jw_weight.assign(numlit, 0);
+
+	for (std::uint32_t clause_id = 0; clause_id < numclause; ++clause_id)
+	{
+		_free_count[clause_id] = static_cast<std::uint32_t>(clause_size(clause_id));
+		for (std::uint32_t i = _offsets[clause_id]; i < _offsets[clause_id + 1]; ++i)
+		{
+			std::size_t lit = index(_literals[i]);
+			++_live_count[lit];
+			_jw_weight[lit] += jw(clause_size(clause_id));
+			if (clause_size(clause_id) == 2)
+				++_binary_count[lit];
+		}
+	}
+
+	// replay what is already on the trail as if it had been assigned with counting on
+	std::vector<int> trail(_trail);
+	for (int literal : trail)
+		_is_defined[variable(literal)] = 0;
+	_counting = true;
+	for (int literal : trail)
+	{
+		_is_defined[variable(literal)] = 1;
+		count_assignment(literal);
+	}
+}
+
+/**
+ * Pure literals are found incrementally: whenever the live count of a literal drops to zero its
+ * complement becomes a candidate, which is checked once the unit queue runs dry. A candidate is
+ * always checked on the level its count dropped, so candidates are simply discarded on backtrack.
+ */
+
+void UnitPropagator::enable_pure_literals()
+{
+	enable_counts();
+	_pure_literals = true;
+
+	for (std::size_t var = 1; var <= _numvar; ++var)
+	{
+		int literal = static_cast<int>(var);
+		if (_live_count[index(literal)] == 0)
+			_pure_candidates.push_back(-literal);
+		if (_live_count[index(-literal)] == 0)
+			_pure_candidates.push_back(literal);
+	}
+}
+
+bool UnitPropagator::assign_pure_literal()
+{
+	while (!_pure_candidates.empty())
+	{
+		int literal = _pure_candidates.back();
+		_pure_candidates.pop_back();
+
+		if (!_is_defined[variable(literal)] && _live_count[index(-literal)] == 0 && _live_count[index(literal)] > 0)
+			return enqueue(literal, pure_reason);
+	}
+
+	return false;
+}
+
+// Adds delta to the binary counts of the free literals of the clause, counting the assigned literal as free.
+void UnitPropagator::count_binary(std::uint32_t clause_id, int assigned, int delta)
+{
+	for (std::uint32_t i = _offsets[clause_id]; i < _offsets[clause_id + 1]; ++i)
+		if (_literals[i] == assigned || !_is_defined[variable(_literals[i])])
+			_binary_count[index(_literals[i])] += static_cast<std::uint32_t>(delta);
 }
 
-void UnitPropagator::shorten_clause_from_head(int clause_id)
+// Called right after the literal became true.
+void UnitPropagator::count_assignment(int literal)
 {
-	for (int i = _head_index[clause_id] + 1; i <= _tail_index[clause_id]; ++i)
+	std::size_t lit = index(literal);
+	for (std::uint32_t j = _occurrence_start[lit]; j < _occurrence_start[lit + 1]; ++j)
 	{
-		int literal = _clauses[clause_id][i];
-		if (!_is_defined[std::abs(literal)])
+		std::uint32_t clause_id = _occurrences[j];
+		if (_true_count[clause_id]++ == 0)
 		{
-			if (_tail_index[clause_id] == i)
-				_units.push(UnitClause(clause_id, literal));
-			else insert_clause_head_list(clause_id, literal);
+			for (std::uint32_t i = _offsets[clause_id]; i < _offsets[clause_id + 1]; ++i)
+			{
+				if (--_live_count[index(_literals[i])] == 0 && _pure_literals)
+					_pure_candidates.push_back(-_literals[i]);
+				_jw_weight[index(_literals[i])] -= jw(clause_size(clause_id));
+			}
+			if (_free_count[clause_id] == 2)
+				count_binary(clause_id, literal, -1);
 		}
-		else if (_value[std::abs(literal)]) return;
+		--_free_count[clause_id];
+	}
+
+	lit = index(-literal);
+	for (std::uint32_t j = _occurrence_start[lit]; j < _occurrence_start[lit + 1]; ++j)
+	{
+		std::uint32_t clause_id = _occurrences[j];
+		if (_true_count[clause_id] == 0)
+		{
+			if (_free_count[clause_id] == 2)
+				count_binary(clause_id, -literal, -1);
+			else if (_free_count[clause_id] == 3)
+				count_binary(clause_id, 0, 1);
+		}
+		--_free_count[clause_id];
+	}
+}
+
+// Called right before the literal becomes unassigned, undoing count_assignment.
+void UnitPropagator::count_unassignment(int literal)
+{
+	std::size_t lit = index(-literal);
+	for (std::uint32_t j = _occurrence_start[lit]; j < _occurrence_start[lit + 1]; ++j)
+	{
+		std::uint32_t clause_id = _occurrences[j];
+		if (++_free_count[clause_id] == 2 && _true_count[clause_id] == 0)
+			count_binary(clause_id, -literal, 1);
+		else if (_free_count[clause_id] == 3 && _true_count[clause_id] == 0)
+			count_binary(clause_id, 0, -1);
+	}
+
+	lit = index(literal);
+	for (std::uint32_t j = _occurrence_start[lit]; j < _occurrence_start[lit + 1]; ++j)
+	{
+		std::uint32_t clause_id = _occurrences[j];
+		++_free_count[clause_id];
+		if (--_true_count[clause_id] == 0)
+		{
+			for (std::uint32_t i = _offsets[clause_id]; i < _offsets[clause_id + 1]; ++i)
+			{
+				++_live_count[index(_literals[i])];
+				_jw_weight[index(_literals[i])] += jw(clause_size(clause_id));
+			}
+			if (_free_count[clause_id] == 2)
+				count_binary(clause_id, literal, 1);
+		}
+	}
+}
+
+/**
+ * The propagation kernels, one per clause kind. Head and tail never meet, so in a ternary clause they are
+ * either adjacent or have the middle literal between them, which is then the only place the head (tail)
+ * can move to; no kernel but the general one loops over the literals of a clause.
+ */
+
+template<>
+void UnitPropagator::shorten_clause_from_head<ternary_clause>(std::uint32_t clause_id)
+{
+	std::uint32_t &head = _head_index[clause_id];
+	std::uint32_t tail = _tail_index[clause_id];
+
+	if (tail - head == 2)
+	{
+		int middle = _literals[head + 1];
+		if (!_is_defined[variable(middle)])
+		{
+			_undo.emplace_back(clause_id, head, true, true);
+			head = head + 1;
+			_ternary_heads.push(index(middle), clause_id);
+			return;
+		}
+		else if (is_true(middle)) return;
+	}
+	if (!enqueue(_literals[tail], clause_id))
+		_OK = false;
+}
+
+template<>
+void UnitPropagator::shorten_clause_from_tail<ternary_clause>(std::uint32_t clause_id)
+{
+	std::uint32_t head = _head_index[clause_id];
+	std::uint32_t &tail = _tail_index[clause_id];
+
+	if (tail - head == 2)
+	{
+		int middle = _literals[tail - 1];
+		if (!_is_defined[variable(middle)])
+		{
+			_undo.emplace_back(clause_id, tail, false, true);
+			tail = tail - 1;
+			_ternary_tails.push(index(middle), clause_id);
+			return;
+		}
+		else if (is_true(middle)) return;
+	}
+	if (!enqueue(_literals[head], clause_id))
+		_OK = false;
+}
+
+template<>
+void UnitPropagator::shorten_clause_from_head<long_clause>(std::uint32_t clause_id)
+{
+	const int *literals = clause_literals(clause_id);
+	std::uint32_t &head = _head_index[clause_id];
+	std::uint32_t tail = _tail_index[clause_id];
+
+	for (std::uint32_t i = head + 1; i <= tail; ++i)
+	{
+		int literal = literals[i];
+		if (!_is_defined[variable(literal)])
+		{
+			if (tail == i)
+			{
+				if (!enqueue(literal, clause_id))
+					_OK = false;
+			}
+			else
+			{
+				_undo.emplace_back(clause_id, head, true, false);
+				head = i;
+				if (is_learnt(clause_id))
+					_learnt_heads.push(index(literal), clause_id);
+				else
+					_long_heads.push(index(literal), clause_id);
+			}
+			return;
+		}
+		else if (is_true(literal)) return;
 	}
 	// there is an empty clause
+	_conflict_clause = clause_id;
 	_OK = false;
 }
 
 // analogous to shorten_clause_from_head
-void UnitPropagator::shorten_clause_from_tail(int clause_id)
+template<>
+void UnitPropagator::shorten_clause_from_tail<long_clause>(std::uint32_t clause_id)
 {
-	for (int i = _tail_index[clause_id] - 1; i >= _head_index[clause_id]; --i)
+	const int *literals = clause_literals(clause_id);
+	std::uint32_t head = _head_index[clause_id];
+	std::uint32_t &tail = _tail_index[clause_id];
+
+	for (std::uint32_t i = tail; i-- > head;)
 	{
-		int literal = _clauses[clause_id][i];
-		if (!_is_defined[std::abs(literal)])
+		int literal = literals[i];
+		if (!_is_defined[variable(literal)])
 		{
-			if (_head_index[clause_id] == i)
-				_units.push(UnitClause(clause_id, literal));
-			else insert_clause_tail_list(clause_id, literal);
+			if (head == i)
+			{
+				if (!enqueue(literal, clause_id))
+					_OK = false;
+			}
+			else
+			{
+				_undo.emplace_back(clause_id, tail, false, false);
+				tail = i;
+				if (is_learnt(clause_id))
+					_learnt_tails.push(index(literal), clause_id);
+				else
+					_long_tails.push(index(literal), clause_id);
+			}
+			return;
 		}
-		else if (_value[std::abs(literal)]) return;
+		else if (is_true(literal)) return;
 	}
+	_conflict_clause = clause_id;
 	_OK = false;
 }
 
-void UnitPropagator::propagate_true_value(int variable)
+// Walks the lists of the literal kind by kind, binary clauses first. Shortening a clause only pushes
+// onto lists of unassigned literals, never onto the ones walked here.
+void UnitPropagator::propagate_false_literal(int literal)
 {
-	for (int clause_id : _clauses_of_neg_head[variable])
-		if(_OK)
-			shorten_clause_from_head(clause_id);
+	std::size_t lit = index(literal);
+
+	const BinaryImplication *implications = _implications.data();
+	for (std::uint32_t i = _implication_start[lit]; _OK && i < _implication_start[lit + 1]; ++i)
+		if (!enqueue(implications[i].literal, implications[i].clause_id))
+			_OK = false;
+
+	const std::uint32_t *heads = _ternary_heads.clauses.data() + _ternary_heads.start[lit];
+	for (std::uint32_t i = 0; _OK && i < _ternary_heads.size[lit]; ++i)
+		shorten_clause_from_head<ternary_clause>(heads[i]);
+
+	const std::uint32_t *tails = _ternary_tails.clauses.data() + _ternary_tails.start[lit];
+	for (std::uint32_t i = 0; _OK && i < _ternary_tails.size[lit]; ++i)
+		shorten_clause_from_tail<ternary_clause>(tails[i]);
+
+	heads = _long_heads.clauses.data() + _long_heads.start[lit];
+	for (std::uint32_t i = 0; _OK && i < _long_heads.size[lit]; ++i)
+		shorten_clause_from_head<long_clause>(heads[i]);
+
+	tails = _long_tails.clauses.data() + _long_tails.start[lit];
+	for (std::uint32_t i = 0; _OK && i < _long_tails.size[lit]; ++i)
+		shorten_clause_from_tail<long_clause>(tails[i]);
 
-	for (int clause_id : _clauses_of_neg_tail[variable])
-		if(_OK)
-			shorten_clause_from_tail(clause_id);
+	if (!_learning)
+		return;
+
+	const std::vector<std::uint32_t> &learnt_heads = _learnt_heads.clauses[lit];
+	for (std::size_t i = 0; _OK && i < learnt_heads.size(); ++i)
+		shorten_clause_from_head<long_clause>(learnt_heads[i]);
+
+	const std::vector<std::uint32_t> &learnt_tails = _learnt_tails.clauses[lit];
+	for (std::size_t i = 0; _OK && i < learnt_tails.size(); ++i)
+		shorten_clause_from_tail<long_clause>(learnt_tails[i]);
 }
 
-void UnitPropagator::propagate_false_value(int variable)
+bool UnitPropagator::propagate_assumptions(const std::vector<int> &assumptions, AssumptionResult &result)
 {
-	for (int clause_id : _clauses_of_pos_head[variable])
-		if(_OK)
-			shorten_clause_from_head(clause_id);
+	backtrack(0);
+	result.implied.clear();
+	result.conflict = !_OK;
+
+	if (!_OK)
+		return false;
+
+	_trail_limits.push_back(_trail.size());
+	_undo_limits.push_back(_undo.size());
+
+	for (std::size_t i = 0; _OK && i < assumptions.size(); ++i)
+		if (!enqueue(assumptions[i], decision_reason))
+			_OK = false;
 
-	for (int clause_id : _clauses_of_pos_tail[variable])
-		if(_OK)
-			shorten_clause_from_tail(clause_id);
+	std::size_t implied = _trail.size();
+
+	if (propagate())
+		result.implied.assign(_trail.begin() + static_cast<std::ptrdiff_t>(implied), _trail.end());
+	else
+		result.conflict = true;
+
+	backtrack(0);
+	return !result.conflict;
 }
 
-std::vector<std::vector<int>> UnitPropagator::produce_output()
+std::vector<AssumptionResult> propagate_assumption_sets(std::shared_ptr<const ClauseStore> store,
+	const std::vector<std::vector<int>> &assumption_sets, std::size_t threads)
 {
-	// TODO: return clauses with applied unit propagation.
-	return _clauses;
+	std::vector<AssumptionResult> results(assumption_sets.size());
+	std::atomic<std::size_t> next(0);
+
+	auto work = [&]() {
+		UnitPropagator propagator(store);
+		propagator.propagate();
+
+		for (std::size_t i = next++; i < assumption_sets.size(); i = next++)
+			propagator.propagate_assumptions(assumption_sets[i], results[i]);
+	};
+
+	threads = std::max<std::size_t>(1, std::min(threads, assumption_sets.size()));
+
+	std::vector<std::thread> pool;
+	for (std::size_t i = 1; i < threads; ++i)
+		pool.emplace_back(work);
+	work();
+
+	for (std::thread &thread : pool)
+		thread.join();
+
+	return results;
 }
 
-std::pair<bool, std::vector<std::vector<int>>> UnitPropagator::propagate()
+void UnitPropagator::produce_output(ResidualFormula &output) const
 {
-	for (int c = 0; c < _clauses.size(); ++c)
+	output.literals.clear();
+	output.offsets.clear();
+	output.units.assign(_trail.begin(), _trail.end());
+	output.offsets.push_back(0);
+
+	for (std::size_t c = 0; c + 1 < _offsets.size(); ++c)
 	{
-		if (_head_index[c] == _tail_index[c])
-			_units.push(UnitClause(c, _clauses[c][_head_index[c]]));
+		std::size_t size = output.literals.size();
+		bool satisfied = false;
+
+		for (std::uint32_t i = _offsets[c]; !satisfied && i < _offsets[c + 1]; ++i)
+		{
+			int literal = _literals[i];
+			if (!_is_defined[variable(literal)])
+				output.literals.push_back(literal);
+			else
+				satisfied = is_true(literal);
+		}
+
+		if (satisfied)
+			output.literals.resize(size);
+		else
+			output.offsets.push_back(static_cast<std::uint32_t>(output.literals.size()));
 	}
+}
 
-	while(_OK && !_units.empty())
+bool UnitPropagator::propagate()
+{
+	do
 	{
-		UnitClause L = _units.top();
-		_units.pop();
-		if (_is_defined[std::abs(L.literal)] && _value[std::abs(L.literal)])
+		while (_OK && _queue_head < _trail.size())
+		{
+			propagate_false_literal(-_trail[_queue_head++]);
+			++_propagations;
+		}
+	}
+	while (_OK && _pure_literals && assign_pure_literal());
+
+	return _OK;
+}
+
+bool UnitPropagator::assign(int literal)
+{
+	// a conflict at the root level is final, so no level is opened above it
+	if (!_OK)
+		return false;
+
+	_trail_limits.push_back(_trail.size());
+	_undo_limits.push_back(_undo.size());
+
+	if (!enqueue(literal, decision_reason))
+		_OK = false;
+
+	return propagate();
+}
+
+// Walks the trail backwards from the conflict: every marked variable was assigned after the variables
+// of its reason clause, so one pass expands the whole implication graph above the root level.
+void UnitPropagator::conflict_levels(std::vector<std::uint8_t> &levels)
+{
+	std::size_t pure_level = 0;
+
+	levels.assign(decision_level() + 1, 0);
+
+	// without a conflicting clause (an assumption or decision that was already false) nothing can be ruled out
+	if (_conflict_clause == decision_reason || _conflict_clause == pure_reason)
+	{
+		std::fill(levels.begin() + 1, levels.end(), 1);
+		return;
+	}
+
+	const int *literals = clause_literals(_conflict_clause);
+	for (std::uint32_t i = clause_begin(_conflict_clause); i < clause_end(_conflict_clause); ++i)
+		if (_level[variable(literals[i])] > 0)
+			_seen[variable(literals[i])] = 1;
+
+	for (std::size_t i = _trail.size(); i-- > 0 && _level[variable(_trail[i])] > 0;)
+	{
+		std::size_t var = variable(_trail[i]);
+		std::uint32_t reason = _reason[var];
+
+		if (!_seen[var])
 			continue;
+		_seen[var] = 0;
+
+		if (reason == decision_reason)
+			levels[_level[var]] = 1;
+		else if (reason == pure_reason)
+			pure_level = std::max<std::size_t>(pure_level, _level[var]);
 		else
 		{
-			if (_is_defined[std::abs(L.literal)] && !_value[std::abs(L.literal)])
-			{
-				_OK = false;
-				break;
-			}
+			const int *reason_literals = clause_literals(reason);
+			for (std::uint32_t j = clause_begin(reason); j < clause_end(reason); ++j)
+				if (_level[variable(reason_literals[j])] > 0 && variable(reason_literals[j]) != var)
+					_seen[variable(reason_literals[j])] = 1;
+		}
+	}
+
+	std::fill(levels.begin() + 1, levels.begin() + static_cast<std::ptrdiff_t>(pure_level) + 1, 1);
+}
+
+void UnitPropagator::backtrack(std::size_t level)
+{
+	if (level >= decision_level())
+		return;
+
+	for (std::size_t i = _undo.size(); i > _undo_limits[level]; --i)
+	{
+		const IndexChange &change = _undo[i - 1];
+		const int *literals = clause_literals(change.clause_id);
+		if (change.head)
+		{
+			std::size_t lit = index(literals[_head_index[change.clause_id]]);
+			if (is_learnt(change.clause_id))
+				_learnt_heads.pop(lit);
+			else if (change.ternary)
+				_ternary_heads.pop(lit);
 			else
-			{
-				_is_defined[std::abs(L.literal)] = true;
-				if (L.positive)
-				{
-					_value[std::abs(L.literal)] = true;
-					propagate_true_value(std::abs(L.literal));
-				}
-				else
-				{
-					_value[std::abs(L.literal)] = false;
-					propagate_false_value(std::abs(L.literal));
-				}
-			}
+				_long_heads.pop(lit);
+			_head_index[change.clause_id] = change.old_index;
+		}
+		else
+		{
+			std::size_t lit = index(literals[_tail_index[change.clause_id]]);
+			if (is_learnt(change.clause_id))
+				_learnt_tails.pop(lit);
+			else if (change.ternary)
+				_ternary_tails.pop(lit);
+			else
+				_long_tails.pop(lit);
+			_tail_index[change.clause_id] = change.old_index;
 		}
 	}
+	_undo.erase(_undo.begin() + static_cast<std::ptrdiff_t>(_undo_limits[level]), _undo.end());
+
+	for (std::size_t i = _trail.size(); i > _trail_limits[level]; --i)
+	{
+		if (_counting)
+			count_unassignment(_trail[i - 1]);
+		_is_defined[variable(_trail[i - 1])] = 0;
+	}
+	_trail.resize(_trail_limits[level]);
+
+	_trail_limits.resize(level);
+	_undo_limits.resize(level);
+	_pure_candidates.clear();
+	_queue_head = _trail.size();
+	_OK = true;
+}
+
+/**
+ * Clause learning. A learnt clause is asserting: after backtracking, its first literal is unassigned and
+ * every other literal is false, the last one on the highest level among them. Its head is put on the first
+ * literal and its tail on the last one, so both stand on literals that get unassigned together with the
+ * asserted one, and nothing lies outside of them that might need watching. These initial entries are never
+ * undone, which is why they go below the stack of moved clauses in the learnt lists.
+ */
+
+void UnitPropagator::enable_learning()
+{
+	if (_learning)
+		return;
+
+	_learning = true;
+	_learnt_offsets.assign(1, 0);
+	_level_stamp.assign(_numvar + 1, 0);
+	_stamp = 0;
+	_learnt_heads.clauses.resize(2 * _numvar + 2);
+	_learnt_heads.permanent.assign(2 * _numvar + 2, 0);
+	_learnt_tails.clauses.resize(2 * _numvar + 2);
+	_learnt_tails.permanent.assign(2 * _numvar + 2, 0);
+}
+
+std::size_t UnitPropagator::analyze_conflict(std::vector<int> &learnt)
+{
+	std::size_t current = decision_level();
+	std::size_t pending = 0;
+	std::size_t i = _trail.size();
+	std::uint32_t clause_id = _conflict_clause;
+	int uip = 0;
+
+	learnt.assign(1, 0);
+
+	// resolve the conflicting clause with reasons of current-level literals, latest first, until a single
+	// current-level literal is left
+	do
+	{
+		const int *literals = clause_literals(clause_id);
+
+		for (std::uint32_t j = clause_begin(clause_id); j < clause_end(clause_id); ++j)
+		{
+			std::size_t var = variable(literals[j]);
+
+			if (_seen[var] || _level[var] == 0 || literals[j] == uip)
+				continue;
+
+			_seen[var] = 1;
+			if (_level[var] == current)
+				++pending;
+			else
+				learnt.push_back(literals[j]);
+		}
+
+		while (!_seen[variable(_trail[--i])]);
+
+		uip = _trail[i];
+		_seen[variable(uip)] = 0;
+		clause_id = _reason[variable(uip)];
+	}
+	while (--pending > 0);
+
+	learnt[0] = -uip;
+
+	for (std::size_t j = 1; j < learnt.size(); ++j)
+		_seen[variable(learnt[j])] = 0;
+
+	if (learnt.size() == 1)
+		return 0;
+
+	std::size_t highest = 1;
+	for (std::size_t j = 2; j < learnt.size(); ++j)
+		if (_level[variable(learnt[j])] > _level[variable(learnt[highest])])
+			highest = j;
 
-	return std::make_pair(_OK, produce_output());
-}
\ No newline at end of file
+	std::swap(learnt[highest], learnt.back());
+	return _level[variable(learnt.back())];
+}
+
+bool UnitPropagator::learn(const std::vector<int> &clause)
+{
+	std::uint32_t clause_id = static_cast<std::uint32_t>(_numclause + learnt_clauses());
+	std::uint32_t head = static_cast<std::uint32_t>(_learnt_literals.size());
+
+	std::uint32_t glue = 1;
+
+	// the asserting literal is unassigned by now, but its level differs from all the others
+	++_stamp;
+	for (std::size_t i = 1; i < clause.size(); ++i)
+		if (_level_stamp[_level[variable(clause[i])]] != _stamp)
+		{
+			_level_stamp[_level[variable(clause[i])]] = _stamp;
+			++glue;
+		}
+
+	_learnt_literals.insert(_learnt_literals.end(), clause.begin(), clause.end());
+	_learnt_offsets.push_back(static_cast<std::uint32_t>(_learnt_literals.size()));
+	_learnt_glue.push_back(glue);
+	_head_index.push_back(head);
+	_tail_index.push_back(static_cast<std::uint32_t>(_learnt_literals.size() - 1));
+
+	if (clause.size() > 1)
+	{
+		_learnt_heads.add(index(clause.front()), clause_id);
+		_learnt_tails.add(index(clause.back()), clause_id);
+	}
+
+	if (!enqueue(clause.front(), clause_id))
+		_OK = false;
+
+	return propagate();
+}
+
+// The undo trail of the root level is never unwound, so it can be dropped here along with every learnt list.
+void UnitPropagator::reduce_learnt()
+{
+	if (!_learning || decision_level() > 0 || !_OK)
+		return;
+
+	std::vector<std::uint32_t> order;
+	std::vector<int> literals;
+	std::vector<std::uint32_t> offsets(1, 0);
+	std::vector<std::uint32_t> glue;
+
+	for (std::uint32_t k = 0; k < learnt_clauses(); ++k)
+	{
+		bool satisfied = false;
+		for (std::uint32_t i = _learnt_offsets[k]; !satisfied && i < _learnt_offsets[k + 1]; ++i)
+			satisfied = _is_defined[variable(_learnt_literals[i])] && is_true(_learnt_literals[i]);
+		if (!satisfied)
+			order.push_back(k);
+	}
+
+	std::stable_sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) {
+		return _learnt_glue[a] < _learnt_glue[b] ||
+			(_learnt_glue[a] == _learnt_glue[b] && _learnt_offsets[a + 1] - _learnt_offsets[a] < _learnt_offsets[b + 1] - _learnt_offsets[b]);
+	});
+
+	for (std::size_t n = 0; n < order.size(); ++n)
+	{
+		std::uint32_t k = order[n];
+		if (n >= order.size() / 2 && _learnt_glue[k] > 2)
+			break;
+
+		for (std::uint32_t i = _learnt_offsets[k]; i < _learnt_offsets[k + 1]; ++i)
+			if (!_is_defined[variable(_learnt_literals[i])])
+				literals.push_back(_learnt_literals[i]);
+		offsets.push_back(static_cast<std::uint32_t>(literals.size()));
+		glue.push_back(_learnt_glue[k]);
+	}
+
+	_learnt_literals.swap(literals);
+	_learnt_offsets.swap(offsets);
+	_learnt_glue.swap(glue);
+	_undo.clear();
+	_head_index.resize(_numclause);
+	_tail_index.resize(_numclause);
+	for (std::size_t lit = 0; lit < _learnt_heads.clauses.size(); ++lit)
+	{
+		_learnt_heads.clauses[lit].clear();
+		_learnt_heads.permanent[lit] = 0;
+		_learnt_tails.clauses[lit].clear();
+		_learnt_tails.permanent[lit] = 0;
+	}
+
+	// at the root fixpoint a clause that is not satisfied has two unassigned literals at least
+	for (std::uint32_t k = 0; k < learnt_clauses(); ++k)
+	{
+		std::uint32_t clause_id = _numclause + k;
+
+		_head_index.push_back(_learnt_offsets[k]);
+		_tail_index.push_back(_learnt_offsets[k + 1] - 1);
+		_learnt_heads.add(index(_learnt_literals[_learnt_offsets[k]]), clause_id);
+		_learnt_tails.add(index(_learnt_literals[_learnt_offsets[k + 1] - 1]), clause_id);
+	}
+
+	// reasons on the root level are never looked at, but must not name clauses that are gone
+	for (int literal : _trail)
+		if (_reason[variable(literal)] != decision_reason && is_learnt(_reason[variable(literal)]))
+			_reason[variable(literal)] = decision_reason;
+}
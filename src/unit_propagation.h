@@ -1,51 +1,249 @@
 #ifndef _UNIT_PROP
 #define _UNIT_PROP
 
-#include <queue>
-#include <stack>
-#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
-struct UnitClause {
-	int clause_id;
+// Literals are indexed as 2 * variable for the positive and 2 * variable + 1 for the negative phase.
+inline std::size_t literal_index(int literal) { return literal > 0 ? 2 * static_cast<std::size_t>(literal) : 2 * static_cast<std::size_t>(-literal) + 1; }
+
+// Clauses are propagated by kind, each with a kernel of its own: binary and ternary clauses, and the
+// long kind (which takes every other width) propagated by the general loop.
+enum ClauseKind { long_clause = 0, binary_clause = 2, ternary_clause = 3 };
+inline ClauseKind clause_kind(std::size_t size) { return size == 2 ? binary_clause : size == 3 ? ternary_clause : long_clause; }
+
+// A binary clause as seen from one of its literals: once that literal is false, the other is implied.
+struct BinaryImplication {
 	int literal;
-	bool positive;
-	explicit UnitClause(int c, int l)
+	std::uint32_t clause_id;
+};
+
+// The clause database, read-only once built so that several propagators can share it. Clauses are
+// stored back to back in one literal array delimited by an offsets array (the layout read_dimacs
+// produces), with duplicate literals removed and tautologies left out; occurrences lists the clauses
+// of every literal, grouped by literal. The occurrences are also split by clause kind: those in binary
+// clauses as the implications of every literal, and for the other kinds just the number per literal,
+// laid out as start offsets for the head/tail lists of that kind.
+struct ClauseStore {
+	std::size_t numvar;
+	std::vector<int> literals;
+	std::vector<std::uint32_t> offsets;
+	std::vector<std::uint32_t> occurrences;
+	std::vector<std::uint32_t> occurrence_start;
+	std::vector<BinaryImplication> implications;
+	std::vector<std::uint32_t> implication_start;
+	std::vector<std::uint32_t> ternary_start;
+	std::vector<std::uint32_t> long_start;
+
+	ClauseStore(const std::vector<std::vector<int>> &clauses, std::size_t numvar);
+	// Takes over clauses already in the flat layout (as read by read_dimacs).
+	ClauseStore(std::vector<int> literals, std::vector<std::uint32_t> offsets, std::size_t numvar);
+
+	std::size_t size() const { return offsets.size() - 1; }
+
+private:
+	void build();
+};
+
+// A head/tail index that was moved during propagation; the clause was pushed onto the list
+// of the literal at its new index, so backtracking pops it from there and restores the index.
+// The kind tells which lists that was without looking the clause up.
+struct IndexChange {
+	std::uint32_t clause_id;
+	std::uint32_t old_index;
+	bool head;
+	bool ternary;
+	explicit IndexChange(std::uint32_t c, std::uint32_t i, bool h, bool t)
 	{
 		clause_id = c;
-		literal = l;
-		positive = l > 0;
+		old_index = i;
+		head = h;
+		ternary = t;
 	}
 };
 
+// Clauses of one kind on every literal's head (or tail) list live in one arena; the list of a literal
+// is a fixed-capacity segment sized by the number of occurrences of that literal in clauses of the kind.
+struct OccurrenceArena {
+	std::vector<std::uint32_t> clauses;
+	const std::uint32_t *start;
+	std::vector<std::uint32_t> size;
+
+	void push(std::size_t literal, std::uint32_t clause_id) { clauses[start[literal] + size[literal]++] = clause_id; }
+	void pop(std::size_t literal) { --size[literal]; }
+};
+
+// Head (or tail) lists of learnt clauses, which unlike the arena have to grow: the list of a literal
+// starts with the clauses learnt with their head (tail) on it, which stay for good, followed by the
+// stack of clauses moved there, which backtracking pops.
+struct LearntLists {
+	std::vector<std::vector<std::uint32_t>> clauses;
+	std::vector<std::uint32_t> permanent;
+
+	void add(std::size_t literal, std::uint32_t clause_id) { clauses[literal].insert(clauses[literal].begin() + permanent[literal]++, clause_id); }
+	void push(std::size_t literal, std::uint32_t clause_id) { clauses[literal].push_back(clause_id); }
+	void pop(std::size_t literal) { clauses[literal].pop_back(); }
+};
+
+// The formula left after propagation, in the same flat layout as the clause store: satisfied
+// clauses are dropped, false literals are stripped and the assigned literals are kept as units.
+struct ResidualFormula {
+	std::vector<int> literals;
+	std::vector<std::uint32_t> offsets;
+	std::vector<int> units;
+
+	std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+// The outcome of propagating one set of assumption literals: either a conflict, or the literals
+// the assumptions imply beyond the root level (the assumptions themselves are not repeated).
+struct AssumptionResult {
+	bool conflict;
+	std::vector<int> implied;
+
+	AssumptionResult() : conflict(false) {}
+};
+
 class UnitPropagator {
+	std::shared_ptr<const ClauseStore> _store;
 	std::size_t _numvar;
-	std::vector<std::vector<int>> _clauses;
-	std::vector<bool> _is_defined;
-	std::vector<bool> _value;
-	std::vector<int> _head_index;
-	std::vector<int> _tail_index;
-	std::vector<std::vector<int>> _clauses_of_pos_head;
-	std::vector<std::vector<int>> _clauses_of_neg_head;
-	std::vector<std::vector<int>> _clauses_of_pos_tail;
-	std::vector<std::vector<int>> _clauses_of_neg_tail;
-	std::queue<int> _literal_queue;
-	std::stack<UnitClause> _units;
+	const std::vector<int> &_literals;
+	const std::vector<std::uint32_t> &_offsets;
+	const std::vector<std::uint32_t> &_occurrences;
+	const std::vector<std::uint32_t> &_occurrence_start;
+	const std::vector<BinaryImplication> &_implications;
+	const std::vector<std::uint32_t> &_implication_start;
+	std::vector<std::uint8_t> _is_defined;
+	std::vector<std::uint8_t> _value;
+	std::vector<std::uint32_t> _head_index;
+	std::vector<std::uint32_t> _tail_index;
+	OccurrenceArena _ternary_heads;
+	OccurrenceArena _ternary_tails;
+	OccurrenceArena _long_heads;
+	OccurrenceArena _long_tails;
+	std::vector<int> _trail;
+	std::vector<std::size_t> _trail_limits;
+	std::vector<IndexChange> _undo;
+	std::vector<std::size_t> _undo_limits;
+	std::size_t _queue_head;
+	std::uint64_t _propagations;
 	bool _OK;
 
-	void insert_clause_head_list(int clause_id, int literal);
-	void insert_clause_tail_list(int clause_id, int literal);
-	void shorten_clause_from_head(int clause_id);
-	void shorten_clause_from_tail(int clause_id);
-	void propagate_true_value(int variable);
-	void propagate_false_value(int variable);
-	std::vector<std::vector<int>> produce_output();
+	// why each variable was assigned: the clause that became unit, or one of the markers below
+	static const std::uint32_t decision_reason = UINT32_MAX;
+	static const std::uint32_t pure_reason = UINT32_MAX - 1;
+	std::vector<std::uint32_t> _level;
+	std::vector<std::uint32_t> _reason;
+	std::uint32_t _conflict_clause;
+	std::vector<std::uint8_t> _seen;
+
+	bool _counting;
+	std::vector<std::uint32_t> _true_count;
+	std::vector<std::uint32_t> _free_count;
+	std::vector<std::uint32_t> _live_count;
+	std::vector<std::uint32_t> _binary_count;
+	std::vector<std::uint64_t> _jw_weight;
+
+	bool _pure_literals;
+	std::vector<int> _pure_candidates;
+
+	// learnt clauses are private to the propagator and numbered on from the clauses of the store;
+	// their head/tail indices are positions in _learnt_literals
+	bool _learning;
+	std::uint32_t _numclause;
+	std::vector<int> _learnt_literals;
+	std::vector<std::uint32_t> _learnt_offsets;
+	std::vector<std::uint32_t> _learnt_glue;
+	LearntLists _learnt_heads;
+	LearntLists _learnt_tails;
+	std::vector<std::uint64_t> _level_stamp;
+	std::uint64_t _stamp;
+
+	static std::size_t index(int literal) { return literal_index(literal); }
+	static std::size_t variable(int literal) { return static_cast<std::size_t>(literal > 0 ? literal : -literal); }
+	bool is_true(int literal) const { return _value[variable(literal)] == (literal > 0); }
+
+	std::size_t clause_size(std::uint32_t clause_id) const { return _offsets[clause_id + 1] - _offsets[clause_id]; }
+	bool is_learnt(std::uint32_t clause_id) const { return clause_id >= _numclause; }
+	const int *clause_literals(std::uint32_t clause_id) const { return is_learnt(clause_id) ? _learnt_literals.data() : _literals.data(); }
+	std::uint32_t clause_begin(std::uint32_t clause_id) const { return is_learnt(clause_id) ? _learnt_offsets[clause_id - _numclause] : _offsets[clause_id]; }
+	std::uint32_t clause_end(std::uint32_t clause_id) const { return is_learnt(clause_id) ? _learnt_offsets[clause_id - _numclause + 1] : _offsets[clause_id + 1]; }
+	static std::uint64_t jw(std::size_t size) { return size < 32 ? std::uint64_t(1) << (32 - size) : 1; }
+
+	bool enqueue(int literal, std::uint32_t reason);
+	void count_binary(std::uint32_t clause_id, int assigned, int delta);
+	void count_assignment(int literal);
+	void count_unassignment(int literal);
+	bool assign_pure_literal();
+	// The kernels shortening a clause of the given kind whose head (tail) literal became false; the
+	// general one (long_clause) also serves learnt clauses of any width.
+	template<ClauseKind kind> void shorten_clause_from_head(std::uint32_t clause_id);
+	template<ClauseKind kind> void shorten_clause_from_tail(std::uint32_t clause_id);
+	void propagate_false_literal(int literal);
 
 public:
+	explicit UnitPropagator(std::shared_ptr<const ClauseStore> store);
 	UnitPropagator(const std::vector<std::vector<int>> &clauses, std::size_t numvar);
-	std::pair<bool, std::vector<std::vector<int>>> propagate();
 
+	// Propagates all pending assignments (and pure literals, if enabled) to a fixpoint; returns false on conflict.
+	bool propagate();
+	// Opens a new decision level, assigns the literal and propagates.
+	bool assign(int literal);
+	// Undoes every assignment and index move made above the given level.
+	void backtrack(std::size_t level);
+	// Backtracks to the root, propagates the assumptions together on one level, records what they
+	// imply and backtracks again; returns false on conflict.
+	bool propagate_assumptions(const std::vector<int> &assumptions, AssumptionResult &result);
+	// After a conflict, sets levels[l] for every decision level l > 0 the conflict depends on, found by
+	// following the reasons of the conflicting clause back to decisions. A pure literal is taken to depend
+	// on every level up to its own.
+	void conflict_levels(std::vector<std::uint8_t> &levels);
+	// Writes the residual formula into output, reusing its buffers.
+	void produce_output(ResidualFormula &output) const;
+	// Starts maintaining occurrence counts of literals over the unresolved clauses.
+	void enable_counts();
+	// Makes propagate also assign literals whose complement occurs in no unresolved clause.
+	void enable_pure_literals();
+	// Lets learn add clauses; they stay private to this propagator, the store is left alone.
+	void enable_learning();
+	// After a conflict above the root level (without pure literals), derives the first-UIP clause into
+	// learnt, with the asserting literal first and a literal of the highest remaining level last, and
+	// returns that level.
+	std::size_t analyze_conflict(std::vector<int> &learnt);
+	// Adds a clause from analyze_conflict once backtracked to the level it returned, asserts its first
+	// literal and propagates; returns false on conflict.
+	bool learn(const std::vector<int> &clause);
+	// At the root level, drops the learnt clauses satisfied there and the worse half of the others by
+	// glue (the number of decision levels among their literals when learnt), keeping every clause of
+	// glue 2 or less; literals false at the root are stripped from the clauses kept.
+	void reduce_learnt();
+
+	std::size_t decision_level() const { return _trail_limits.size(); }
+	std::size_t numvar() const { return _numvar; }
+	bool is_defined(std::size_t variable) const { return _is_defined[variable] != 0; }
+	bool value(std::size_t variable) const { return _value[variable] != 0; }
+	const std::vector<int> &trail() const { return _trail; }
+	// The decision level the variable was assigned on.
+	std::size_t level(std::size_t variable) const { return _level[variable]; }
+	std::size_t clauses() const { return _numclause; }
+	// The number of literals whose consequences propagation has worked out so far.
+	std::uint64_t propagations() const { return _propagations; }
+	std::size_t learnt_clauses() const { return _learnt_offsets.empty() ? 0 : _learnt_offsets.size() - 1; }
+
+	// Occurrence counts, valid after enable_counts(): occurrences in unresolved clauses, occurrences
+	// as a free literal of unresolved clauses with two free literals, and the Jeroslow-Wang weight
+	// (sum of 2^(32 - |C|) over unresolved clauses C containing the literal).
+	std::uint32_t live_count(int literal) const { return _live_count[index(literal)]; }
+	std::uint32_t binary_count(int literal) const { return _binary_count[index(literal)]; }
+	std::uint64_t jw_weight(int literal) const { return _jw_weight[index(literal)]; }
 };
 
+// Propagates every assumption set from the root state of the store, indexing the formula once per
+// thread and handing the sets out to up to threads propagators.
+std::vector<AssumptionResult> propagate_assumption_sets(std::shared_ptr<const ClauseStore> store,
+	const std::vector<std::vector<int>> &assumption_sets, std::size_t threads = 1);
+
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * Runs every engine on every instance, one process at a time, under a wall-clock limit and an
+ * address-space limit, and records wall and CPU time and peak RSS from wait4 together with the
+ * conflicts and propagations each engine reports on stdout. Answers are compared across engines
+ * per instance: an instance some engine calls SAT and another UNSAT is a disagreement, which makes
+ * the exit status 1. Results go to <prefix>.csv and <prefix>.json, and a per-engine summary to stdout.
+ */
+
+struct Engine {
+	const char *name;
+	const char *path;
+	std::vector<const char *> arguments;
+};
+
+static const std::vector<Engine> engines = {
+	{"dpll", "bin/DPLL", {}},
+	{"dpll-jw", "bin/DPLL", {"-b", "jw"}},
+	{"dpll-cdcl", "bin/DPLL", {"-c"}},
+	{"tinisat", "src/tinisat0.22/tinisat", {}},
+	{"minisat", "src/minisat/core/minisat", {}},
+	{"minisat-simp", "src/minisat/simp/minisat", {}},
+};
+
+struct Options {
+	std::string root = "..";
+	double time_limit = 60;
+	std::size_t memory_limit = 2048;
+	std::string prefix = "results";
+	std::vector<std::string> engines;
+	std::vector<std::string> inputs;
+};
+
+struct Result {
+	std::string instance;
+	const Engine *engine;
+	std::string status;
+	double wall;
+	double cpu;
+	long peak_rss;
+	// -1 where the engine did not report the counter
+	std::int64_t conflicts;
+	std::int64_t propagations;
+};
+
+// Reads the counter named word from a line, either as "N word" (DPLL, Tinisat) or "word : N" (MiniSat).
+static bool parse_counter(const std::string &line, const char *word, std::int64_t &value)
+{
+	std::size_t at = line.find(word);
+
+	if(at == std::string::npos)
+		return false;
+
+	std::size_t after = line.find_first_not_of(' ', at + std::strlen(word));
+	if(after != std::string::npos && line[after] == ':')
+	{
+		value = std::strtoll(line.c_str() + after + 1, nullptr, 10);
+		return true;
+	}
+
+	std::size_t end = line.find_last_not_of(' ', at == 0 ? 0 : at - 1);
+	if(at == 0 || end == std::string::npos || line[end] < '0' || line[end] > '9')
+		return false;
+
+	std::size_t begin = end;
+	while(begin > 0 && line[begin - 1] >= '0' && line[begin - 1] <= '9')
+		--begin;
+
+	value = std::strtoll(line.c_str() + begin, nullptr, 10);
+	return true;
+}
+
+// Fills in the answer and counters from the engine's output; returns false when it gave no answer.
+static bool parse_output(const char *path, Result &result)
+{
+	std::ifstream in(path);
+	std::string line;
+	bool answered = false;
+
+	while(std::getline(in, line))
+	{
+		if(line == "s SATISFIABLE" || line == "SATISFIABLE")
+		{
+			result.status = "SAT";
+			answered = true;
+		}
+		else if(line == "s UNSATISFIABLE" || line == "UNSATISFIABLE")
+		{
+			result.status = "UNSAT";
+			answered = true;
+		}
+		else if(line.find("bad_alloc") != std::string::npos || line == "INDETERMINATE")
+			result.status = "memout";
+		else if(line.compare(0, 2, "v ") != 0)
+		{
+			parse_counter(line, "conflicts", result.conflicts);
+			parse_counter(line, "propagations", result.propagations);
+		}
+	}
+
+	return answered;
+}
+
+static Result run(const Options &options, const Engine &engine, const std::string &instance)
+{
+	Result result;
+	result.instance = instance;
+	result.engine = &engine;
+	result.status = "error";
+	result.wall = result.cpu = 0;
+	result.peak_rss = 0;
+	result.conflicts = result.propagations = -1;
+
+	char output[] = "/tmp/benchmark_runner.XXXXXX";
+	int fd = mkstemp(output);
+	if(fd < 0)
+		return result;
+
+	std::string binary = options.root + "/" + engine.path;
+	std::vector<char *> argv;
+	argv.push_back(const_cast<char *>(binary.c_str()));
+	for(const char *argument : engine.arguments)
+		argv.push_back(const_cast<char *>(argument));
+	argv.push_back(const_cast<char *>(instance.c_str()));
+	argv.push_back(nullptr);
+
+	auto start = std::chrono::steady_clock::now();
+	pid_t pid = fork();
+
+	if(pid == 0)
+	{
+		rlimit memory = {options.memory_limit << 20, options.memory_limit << 20};
+		rlimit cpu = {static_cast<rlim_t>(options.time_limit) + 1, static_cast<rlim_t>(options.time_limit) + 2};
+		setrlimit(RLIMIT_AS, &memory);
+		setrlimit(RLIMIT_CPU, &cpu);
+		dup2(fd, STDOUT_FILENO);
+		dup2(fd, STDERR_FILENO);
+		execv(argv[0], argv.data());
+		_exit(127);
+	}
+
+	close(fd);
+	if(pid < 0)
+	{
+		unlink(output);
+		return result;
+	}
+
+	int status = 0;
+	rusage usage;
+	bool timed_out = false;
+
+	while(wait4(pid, &status, WNOHANG, &usage) == 0)
+	{
+		if(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > options.time_limit)
+		{
+			kill(pid, SIGKILL);
+			wait4(pid, &status, 0, &usage);
+			timed_out = true;
+			break;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+
+	result.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.cpu = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+	result.peak_rss = usage.ru_maxrss;
+
+	if(!parse_output(output, result) && (timed_out || (WIFSIGNALED(status) && WTERMSIG(status) == SIGXCPU)))
+		result.status = "timeout";
+
+	unlink(output);
+	return result;
+}
+
+static void list_instances(const std::string &input, std::vector<std::string> &instances)
+{
+	struct stat info;
+
+	if(stat(input.c_str(), &info) != 0)
+	{
+		std::fprintf(stderr, "skipping %s: %s\n", input.c_str(), std::strerror(errno));
+		return;
+	}
+
+	if(!S_ISDIR(info.st_mode))
+	{
+		instances.push_back(input);
+		return;
+	}
+
+	DIR *dir = opendir(input.c_str());
+	std::vector<std::string> found;
+
+	for(dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+	{
+		std::string path = input + "/" + entry->d_name;
+
+		// the manifest of the benchmark tests sits among the instances
+		if(entry->d_name[0] != '.' && std::strcmp(entry->d_name, "MANIFEST") != 0 && stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+			found.push_back(path);
+	}
+
+	closedir(dir);
+	std::sort(found.begin(), found.end());
+	instances.insert(instances.end(), found.begin(), found.end());
+}
+
+static std::string json_string(const std::string &text)
+{
+	std::string quoted = "\"";
+
+	for(char c : text)
+	{
+		if(c == '"' || c == '\\')
+			quoted += '\\';
+		quoted += c;
+	}
+
+	return quoted + "\"";
+}
+
+static std::string counter(std::int64_t value, const char *missing)
+{
+	return value < 0 ? missing : std::to_string(value);
+}
+
+static void write_results(const std::string &prefix, const std::vector<Result> &results)
+{
+	std::ofstream csv(prefix + ".csv");
+	std::ofstream json(prefix + ".json");
+
+	csv << "instance,engine,status,wall_s,cpu_s,peak_rss_kb,conflicts,propagations\n";
+	json << "[\n";
+
+	for(std::size_t i = 0; i < results.size(); ++i)
+	{
+		const Result &r = results[i];
+		char times[64];
+		std::snprintf(times, sizeof(times), "%.3f,%.3f", r.wall, r.cpu);
+
+		csv << r.instance << ',' << r.engine->name << ',' << r.status << ',' << times << ',' << r.peak_rss << ','
+			<< counter(r.conflicts, "") << ',' << counter(r.propagations, "") << '\n';
+
+		std::snprintf(times, sizeof(times), "\"wall_s\": %.3f, \"cpu_s\": %.3f", r.wall, r.cpu);
+		json << "  {\"instance\": " << json_string(r.instance) << ", \"engine\": " << json_string(r.engine->name)
+			<< ", \"status\": " << json_string(r.status) << ", " << times << ", \"peak_rss_kb\": " << r.peak_rss
+			<< ", \"conflicts\": " << counter(r.conflicts, "null") << ", \"propagations\": " << counter(r.propagations, "null")
+			<< (i + 1 < results.size() ? "},\n" : "}\n");
+	}
+
+	json << "]\n";
+}
+
+// Per engine: answers, failures, total time on solved instances and PAR-2 (a failure costs twice the limit).
+static void print_summary(const Options &options, const std::vector<const Engine *> &selected, const std::vector<Result> &results)
+{
+	std::printf("\n%-14s %6s %6s %6s %8s %7s %6s %10s %10s %10s\n", "engine", "solved", "sat", "unsat", "timeout", "memout", "error",
+		"time(s)", "PAR-2(s)", "max RSS");
+
+	for(const Engine *engine : selected)
+	{
+		std::size_t sat = 0, unsat = 0, timeout = 0, memout = 0, error = 0;
+		double time = 0, par2 = 0;
+		long rss = 0;
+
+		for(const Result &r : results)
+		{
+			if(r.engine != engine)
+				continue;
+
+			bool solved = r.status == "SAT" || r.status == "UNSAT";
+			sat += r.status == "SAT";
+			unsat += r.status == "UNSAT";
+			timeout += r.status == "timeout";
+			memout += r.status == "memout";
+			error += r.status == "error";
+			time += solved ? r.wall : 0;
+			par2 += solved ? r.wall : 2 * options.time_limit;
+			rss = std::max(rss, r.peak_rss);
+		}
+
+		std::printf("%-14s %6zu %6zu %6zu %8zu %7zu %6zu %10.2f %10.2f %7ld MB\n", engine->name, sat + unsat, sat, unsat, timeout, memout, error,
+			time, par2, rss >> 10);
+	}
+}
+
+static void usage(const char *program)
+{
+	std::printf("Usage: %s [-R root] [-t seconds] [-m megabytes] [-o prefix] [-e engine,...] instance|directory...\n", program);
+	std::printf("  -R  repository root the engine binaries are found under (default: ..)\n");
+	std::printf("  -t  wall-clock limit per run (default: 60)\n");
+	std::printf("  -m  address-space limit per run (default: 2048)\n");
+	std::printf("  -o  results go to prefix.csv and prefix.json (default: results)\n");
+	std::printf("  -e  engines to run (default: all of");
+	for(const Engine &engine : engines)
+		std::printf(" %s", engine.name);
+	std::printf(")\n");
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		bool has_value = i + 1 < argc;
+
+		if(std::strcmp(argv[i], "-R") == 0 && has_value)
+			options.root = argv[++i];
+		else if(std::strcmp(argv[i], "-t") == 0 && has_value && std::atof(argv[i + 1]) > 0)
+			options.time_limit = std::atof(argv[++i]);
+		else if(std::strcmp(argv[i], "-m") == 0 && has_value && std::atoi(argv[i + 1]) > 0)
+			options.memory_limit = static_cast<std::size_t>(std::atoi(argv[++i]));
+		else if(std::strcmp(argv[i], "-o") == 0 && has_value)
+			options.prefix = argv[++i];
+		else if(std::strcmp(argv[i], "-e") == 0 && has_value)
+		{
+			std::stringstream names(argv[++i]);
+			std::string name;
+			while(std::getline(names, name, ','))
+				options.engines.push_back(name);
+		}
+		else if(argv[i][0] != '-')
+			options.inputs.push_back(argv[i]);
+		else
+		{
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if(options.inputs.empty())
+	{
+		usage(argv[0]);
+		return -1;
+	}
+
+	std::vector<const Engine *> selected;
+
+	for(const Engine &engine : engines)
+	{
+		if(!options.engines.empty() && std::find(options.engines.begin(), options.engines.end(), engine.name) == options.engines.end())
+			continue;
+
+		if(access((options.root + "/" + engine.path).c_str(), X_OK) != 0)
+		{
+			std::fprintf(stderr, "skipping %s: %s/%s is not built\n", engine.name, options.root.c_str(), engine.path);
+			continue;
+		}
+
+		selected.push_back(&engine);
+	}
+
+	std::vector<std::string> instances;
+	for(const std::string &input : options.inputs)
+		list_instances(input, instances);
+
+	std::vector<Result> results;
+	std::size_t disagreements = 0;
+
+	for(const std::string &instance : instances)
+	{
+		const Result *sat = nullptr, *unsat = nullptr;
+
+		for(const Engine *engine : selected)
+		{
+			results.push_back(run(options, *engine, instance));
+			const Result &r = results.back();
+
+			std::printf("%-40s %-14s %-8s %8.2fs %8ld KB\n", instance.c_str(), engine->name, r.status.c_str(), r.wall, r.peak_rss);
+			std::fflush(stdout);
+		}
+
+		for(std::size_t i = results.size() - selected.size(); i < results.size(); ++i)
+		{
+			if(results[i].status == "SAT")
+				sat = &results[i];
+			else if(results[i].status == "UNSAT")
+				unsat = &results[i];
+		}
+
+		if(sat != nullptr && unsat != nullptr)
+		{
+			std::printf("DISAGREEMENT on %s: %s says SAT, %s says UNSAT\n", instance.c_str(), sat->engine->name, unsat->engine->name);
+			++disagreements;
+		}
+	}
+
+	write_results(options.prefix, results);
+	print_summary(options, selected, results);
+
+	if(disagreements > 0)
+		std::printf("\n%zu instance(s) with disagreeing answers\n", disagreements);
+
+	return disagreements > 0 ? 1 : 0;
+}
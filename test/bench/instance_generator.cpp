@@ -0,0 +1,403 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Writes a DIMACS CNF instance of one parameterized family to stdout:
+ *
+ *   ksat k n [ratio] [seed]                 uniform random k-SAT, ratio * n clauses of k distinct variables
+ *   php holes                               holes + 1 pigeons in holes holes (UNSAT)
+ *   coloring vertices colors [degree] [seed] colors-coloring of a random graph of the given average degree
+ *   parity n [seed] [sat|unsat]             two XOR chains over the same n variables, in different orders
+ *   factor bits [seed|0xN]                  an array multiplier of two bits-bit factors, both above 1, of N
+ *
+ * Randomness comes from std::mt19937_64, whose output the standard fixes, reduced by modulo rather than
+ * through the (implementation-defined) distributions, so a seed gives the same instance everywhere. For
+ * factor, a seed (the default, 1) stands for N = the product of two random bits-bit numbers, which makes
+ * the instance satisfiable; an explicit prime N (in hex) makes it unsatisfiable.
+ */
+
+class Formula {
+	std::vector<int> _literals;
+	std::size_t _clauses;
+	int _numvar;
+
+public:
+	explicit Formula(int numvar = 0) : _clauses(0), _numvar(numvar) {}
+
+	int fresh() { return ++_numvar; }
+	void add(std::initializer_list<int> clause) { add(clause.begin(), clause.end()); }
+
+	template<class It> void add(It begin, It end)
+	{
+		_literals.insert(_literals.end(), begin, end);
+		_literals.push_back(0);
+		++_clauses;
+	}
+
+	// output <-> a & b
+	int and_gate(int a, int b)
+	{
+		int output = fresh();
+		add({-output, a});
+		add({-output, b});
+		add({output, -a, -b});
+		return output;
+	}
+
+	// output <-> a ^ b
+	int xor_gate(int a, int b)
+	{
+		int output = fresh();
+		add({-output, a, b});
+		add({-output, -a, -b});
+		add({output, -a, b});
+		add({output, a, -b});
+		return output;
+	}
+
+	// output <-> at least two of a, b, c
+	int majority_gate(int a, int b, int c)
+	{
+		int output = fresh();
+		add({-output, a, b});
+		add({-output, a, c});
+		add({-output, b, c});
+		add({output, -a, -b});
+		add({output, -a, -c});
+		add({output, -b, -c});
+		return output;
+	}
+
+	void write(const std::string &comment) const;
+};
+
+static char *write_int(char *out, int value)
+{
+	char digits[12];
+	int n = 0;
+	unsigned magnitude = value < 0 ? 0u - static_cast<unsigned>(value) : static_cast<unsigned>(value);
+
+	if(value < 0)
+		*out++ = '-';
+
+	do
+		digits[n++] = static_cast<char>('0' + magnitude % 10);
+	while((magnitude /= 10) != 0);
+
+	while(n > 0)
+		*out++ = digits[--n];
+
+	return out;
+}
+
+void Formula::write(const std::string &comment) const
+{
+	std::printf("c %s\np cnf %d %zu\n", comment.c_str(), _numvar, _clauses);
+
+	std::vector<char> buffer(1 << 20);
+	char *out = buffer.data();
+
+	for(int literal : _literals)
+	{
+		if(out - buffer.data() > static_cast<std::ptrdiff_t>(buffer.size()) - 16)
+		{
+			std::fwrite(buffer.data(), 1, static_cast<std::size_t>(out - buffer.data()), stdout);
+			out = buffer.data();
+		}
+
+		out = write_int(out, literal);
+		*out++ = literal == 0 ? '\n' : ' ';
+	}
+
+	std::fwrite(buffer.data(), 1, static_cast<std::size_t>(out - buffer.data()), stdout);
+}
+
+static std::uint64_t below(std::mt19937_64 &rng, std::uint64_t n)
+{
+	return rng() % n;
+}
+
+static void ksat(int k, int n, double ratio, std::uint64_t seed, Formula &formula)
+{
+	std::mt19937_64 rng(seed);
+	std::size_t clauses = static_cast<std::size_t>(ratio * n + 0.5);
+	std::vector<int> clause(static_cast<std::size_t>(k));
+
+	for(std::size_t c = 0; c < clauses; ++c)
+	{
+		for(int i = 0; i < k; ++i)
+		{
+			bool repeated;
+			do
+			{
+				clause[static_cast<std::size_t>(i)] = static_cast<int>(below(rng, static_cast<std::uint64_t>(n))) + 1;
+				repeated = false;
+				for(int j = 0; j < i; ++j)
+					repeated = repeated || clause[static_cast<std::size_t>(j)] == clause[static_cast<std::size_t>(i)];
+			}
+			while(repeated);
+		}
+
+		for(int &literal : clause)
+			if(rng() & 1)
+				literal = -literal;
+
+		formula.add(clause.begin(), clause.end());
+	}
+}
+
+static void php(int holes, Formula &formula)
+{
+	int pigeons = holes + 1;
+	std::vector<int> clause;
+
+	// variable i * holes + j + 1: pigeon i sits in hole j
+	for(int i = 0; i < pigeons; ++i)
+	{
+		clause.clear();
+		for(int j = 0; j < holes; ++j)
+			clause.push_back(i * holes + j + 1);
+		formula.add(clause.begin(), clause.end());
+	}
+
+	for(int j = 0; j < holes; ++j)
+		for(int i = 0; i < pigeons; ++i)
+			for(int l = i + 1; l < pigeons; ++l)
+				formula.add({-(i * holes + j + 1), -(l * holes + j + 1)});
+}
+
+static void coloring(int vertices, int colors, double degree, std::uint64_t seed, Formula &formula)
+{
+	std::mt19937_64 rng(seed);
+	std::size_t edges = static_cast<std::size_t>(degree * vertices / 2 + 0.5);
+	std::vector<int> clause;
+
+	// variable v * colors + c + 1: vertex v has color c
+	for(int v = 0; v < vertices; ++v)
+	{
+		clause.clear();
+		for(int c = 0; c < colors; ++c)
+			clause.push_back(v * colors + c + 1);
+		formula.add(clause.begin(), clause.end());
+
+		for(int c = 0; c < colors; ++c)
+			for(int d = c + 1; d < colors; ++d)
+				formula.add({-(v * colors + c + 1), -(v * colors + d + 1)});
+	}
+
+	for(std::size_t e = 0; e < edges && vertices > 1; ++e)
+	{
+		int a = static_cast<int>(below(rng, static_cast<std::uint64_t>(vertices)));
+		int b = static_cast<int>(below(rng, static_cast<std::uint64_t>(vertices - 1)));
+		if(b >= a)
+			++b;
+
+		for(int c = 0; c < colors; ++c)
+			formula.add({-(a * colors + c + 1), -(b * colors + c + 1)});
+	}
+}
+
+static void parity(int n, std::uint64_t seed, bool satisfiable, Formula &formula)
+{
+	std::mt19937_64 rng(seed);
+	std::vector<int> order(static_cast<std::size_t>(n));
+
+	for(int i = 0; i < n; ++i)
+		order[static_cast<std::size_t>(i)] = i + 1;
+
+	for(std::size_t i = order.size(); i > 1; --i)
+		std::swap(order[i - 1], order[below(rng, i)]);
+
+	int first = 1, second = order[0];
+
+	for(int i = 1; i < n; ++i)
+	{
+		first = formula.xor_gate(first, i + 1);
+		second = formula.xor_gate(second, order[static_cast<std::size_t>(i)]);
+	}
+
+	// both chains compute the parity of all n variables
+	formula.add({first});
+	formula.add({satisfiable ? second : -second});
+}
+
+// Little-endian binary digits of a product of two bits-bit numbers with their top and bottom bits set.
+static std::vector<bool> random_product(int bits, std::uint64_t seed)
+{
+	std::mt19937_64 rng(seed);
+	std::vector<bool> a(static_cast<std::size_t>(bits)), b(static_cast<std::size_t>(bits));
+	std::vector<int> product(2 * static_cast<std::size_t>(bits), 0);
+
+	for(int i = 0; i < bits; ++i)
+	{
+		a[static_cast<std::size_t>(i)] = i == 0 || i == bits - 1 || (rng() & 1);
+		b[static_cast<std::size_t>(i)] = i == 0 || i == bits - 1 || (rng() & 1);
+	}
+
+	for(std::size_t i = 0; i < a.size(); ++i)
+		for(std::size_t j = 0; j < b.size(); ++j)
+			product[i + j] += a[i] && b[j];
+
+	std::vector<bool> digits(product.size());
+	for(std::size_t k = 0; k < product.size(); ++k)
+	{
+		if(k + 1 < product.size())
+			product[k + 1] += product[k] / 2;
+		digits[k] = product[k] % 2 != 0;
+	}
+
+	return digits;
+}
+
+// Sums up to three bits that may be absent (0, standing for false); returns the sum, carry goes to carry.
+static int add_bits(Formula &formula, int x, int y, int z, int &carry)
+{
+	int inputs[3], n = 0;
+
+	for(int bit : {x, y, z})
+		if(bit != 0)
+			inputs[n++] = bit;
+
+	carry = 0;
+	if(n == 0)
+		return 0;
+	if(n == 1)
+		return inputs[0];
+	if(n == 2)
+	{
+		carry = formula.and_gate(inputs[0], inputs[1]);
+		return formula.xor_gate(inputs[0], inputs[1]);
+	}
+
+	carry = formula.majority_gate(inputs[0], inputs[1], inputs[2]);
+	return formula.xor_gate(formula.xor_gate(inputs[0], inputs[1]), inputs[2]);
+}
+
+static void factor(int bits, const std::vector<bool> &target, Formula &formula)
+{
+	std::size_t width = 2 * static_cast<std::size_t>(bits);
+	std::vector<int> sum(width, 0);
+	std::vector<int> clause;
+
+	// variables 1..bits and bits+1..2*bits: the two factors, least significant bit first
+	for(int j = 0; j < bits; ++j)
+	{
+		int carry = 0;
+
+		for(std::size_t position = static_cast<std::size_t>(j); position < width; ++position)
+		{
+			int i = static_cast<int>(position) - j;
+			int partial = i < bits ? formula.and_gate(i + 1, bits + j + 1) : 0;
+
+			if(partial == 0 && carry == 0)
+				break;
+
+			sum[position] = add_bits(formula, sum[position], partial, carry, carry);
+		}
+	}
+
+	for(std::size_t k = 0; k < width; ++k)
+	{
+		bool one = k < target.size() && target[k];
+
+		if(sum[k] != 0)
+			formula.add({one ? sum[k] : -sum[k]});
+		else if(one)
+			formula.add({});
+	}
+
+	// neither factor is 0 or 1
+	for(int offset : {1, bits + 1})
+	{
+		clause.clear();
+		for(int i = 1; i < bits; ++i)
+			clause.push_back(offset + i);
+		formula.add(clause.begin(), clause.end());
+	}
+}
+
+static void usage(const char *program)
+{
+	std::fprintf(stderr, "Usage: %s ksat k n [ratio] [seed]\n", program);
+	std::fprintf(stderr, "       %s php holes\n", program);
+	std::fprintf(stderr, "       %s coloring vertices colors [degree] [seed]\n", program);
+	std::fprintf(stderr, "       %s parity n [seed] [sat|unsat]\n", program);
+	std::fprintf(stderr, "       %s factor bits [seed|0xN]\n", program);
+	std::fprintf(stderr, "  ratio defaults to the phase transition (4.26, 9.93, 21.12 for k = 3, 4, 5), degree to 4.6, seeds to 1\n");
+}
+
+int main(int argc, char **argv)
+{
+	if(argc < 3)
+	{
+		usage(argv[0]);
+		return -1;
+	}
+
+	std::string family = argv[1];
+	std::string comment = family;
+	int size = std::atoi(argv[2]);
+	Formula formula;
+
+	for(int i = 2; i < argc; ++i)
+		comment += std::string(" ") + argv[i];
+
+	if(family == "ksat" && argc >= 4 && size >= 1 && std::atoi(argv[3]) >= size)
+	{
+		static const double threshold[] = {0, 1, 1, 4.26, 9.93, 21.12};
+		int n = std::atoi(argv[3]);
+		// beyond k = 5, the asymptotic 2^k ln 2 - (1 + ln 2) / 2
+		double ratio = argc > 4 ? std::atof(argv[4]) : size <= 5 ? threshold[size] : std::ldexp(std::log(2.0), size) - (1 + std::log(2.0)) / 2;
+
+		formula = Formula(n);
+		ksat(size, n, ratio, argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 1, formula);
+	}
+	else if(family == "php" && size >= 1)
+	{
+		formula = Formula((size + 1) * size);
+		php(size, formula);
+	}
+	else if(family == "coloring" && argc >= 4 && size >= 1 && std::atoi(argv[3]) >= 1)
+	{
+		int colors = std::atoi(argv[3]);
+
+		formula = Formula(size * colors);
+		coloring(size, colors, argc > 4 ? std::atof(argv[4]) : 4.6, argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 1, formula);
+	}
+	else if(family == "parity" && size >= 1)
+	{
+		formula = Formula(size);
+		parity(size, argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1, argc > 4 && std::strcmp(argv[4], "sat") == 0, formula);
+	}
+	else if(family == "factor" && size >= 2)
+	{
+		std::vector<bool> target;
+
+		if(argc > 3 && std::strncmp(argv[3], "0x", 2) != 0)
+			target = random_product(size, std::strtoull(argv[3], nullptr, 10));
+		else if(argc > 3)
+			for(std::uint64_t n = std::strtoull(argv[3], nullptr, 16); n != 0; n /= 2)
+				target.push_back(n & 1);
+		else
+			target = random_product(size, 1);
+
+		formula = Formula(2 * size);
+		factor(size, target, formula);
+	}
+	else
+	{
+		usage(argv[0]);
+		return -1;
+	}
+
+	formula.write(comment);
+	return 0;
+}
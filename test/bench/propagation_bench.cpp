@@ -0,0 +1,156 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bit_propagation.h"
+#include "unit_propagation.h"
+
+/**
+ * Microbenchmark of UnitPropagator: on fixed-seed uniform random 3-SAT instances it repeatedly
+ * assigns random literals until a conflict or a full assignment, then backtracks to the root,
+ * and reports how many literals were propagated per second.
+ */
+
+static std::vector<std::vector<int>> random_3sat(std::size_t numvar, std::size_t numclause, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> variable(1, static_cast<int>(numvar));
+	std::vector<std::vector<int>> clauses(numclause);
+
+	for(std::vector<int> &clause : clauses)
+		for(int i = 0; i < 3; ++i)
+			clause.emplace_back(rng() & 1 ? variable(rng) : -variable(rng));
+
+	return clauses;
+}
+
+static void run(std::size_t numvar, std::size_t rounds)
+{
+	std::size_t numclause = numvar * 42 / 10;
+	std::vector<std::vector<int>> clauses = random_3sat(numvar, numclause, 1);
+	std::mt19937 rng(2);
+	std::uniform_int_distribution<int> variable(1, static_cast<int>(numvar));
+	std::size_t propagations = 0, decisions = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	UnitPropagator propagator(clauses, numvar);
+	auto built = std::chrono::steady_clock::now();
+
+	if(!propagator.propagate())
+	{
+		std::printf("%8zu vars: conflict at root\n", numvar);
+		return;
+	}
+
+	for(std::size_t round = 0; round < rounds; ++round)
+	{
+		while(propagator.trail().size() < numvar)
+		{
+			int v = variable(rng);
+			if(propagator.is_defined(static_cast<std::size_t>(v)))
+				continue;
+
+			std::size_t before = propagator.trail().size();
+			bool ok = propagator.assign(rng() & 1 ? v : -v);
+			propagations += propagator.trail().size() - before;
+			++decisions;
+
+			if(!ok)
+				break;
+		}
+
+		propagator.backtrack(0);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double build_time = std::chrono::duration<double>(built - start).count();
+	double search_time = std::chrono::duration<double>(end - built).count();
+
+	std::printf("%8zu vars %9zu clauses: build %8.3f ms, %10zu decisions, %12zu propagations, %8.3f Mprops/s\n",
+		numvar, numclause, build_time * 1e3, decisions, propagations, static_cast<double>(propagations) / search_time / 1e6);
+}
+
+// Answers the same assumption queries once with a propagator built per query and once in a batch.
+static void run_batch(std::size_t numvar, std::size_t queries, std::size_t threads)
+{
+	std::vector<std::vector<int>> clauses = random_3sat(numvar, numvar * 42 / 10, 1);
+	std::mt19937 rng(3);
+	std::uniform_int_distribution<int> variable(1, static_cast<int>(numvar));
+	std::vector<std::vector<int>> sets(queries);
+
+	for(std::vector<int> &assumptions : sets)
+		for(int i = 0; i < 3; ++i)
+			assumptions.emplace_back(rng() & 1 ? variable(rng) : -variable(rng));
+
+	auto start = std::chrono::steady_clock::now();
+	std::size_t conflicts = 0;
+
+	for(const std::vector<int> &assumptions : sets)
+	{
+		UnitPropagator propagator(clauses, numvar);
+		AssumptionResult result;
+		propagator.propagate();
+		conflicts += !propagator.propagate_assumptions(assumptions, result);
+	}
+
+	auto middle = std::chrono::steady_clock::now();
+	std::vector<AssumptionResult> results = propagate_assumption_sets(std::make_shared<const ClauseStore>(clauses, numvar), sets, threads);
+	auto end = std::chrono::steady_clock::now();
+
+	std::printf("%8zu vars %6zu queries (%zu conflicts): per-query propagator %10.0f queries/s, batch on %zu threads %10.0f queries/s\n",
+		numvar, queries, conflicts, static_cast<double>(queries) / std::chrono::duration<double>(middle - start).count(),
+		threads, static_cast<double>(results.size()) / std::chrono::duration<double>(end - middle).count());
+}
+
+// Answers a batch of assumption queries with the scalar propagator and with the 64 and 256 lane kernels;
+// every query is a common prefix plus one literal of its own, as in lookahead.
+static void run_bitparallel(std::size_t numvar, std::size_t queries, std::size_t prefix)
+{
+	std::shared_ptr<const ClauseStore> store = std::make_shared<const ClauseStore>(random_3sat(numvar, numvar * 35 / 10, 1), numvar);
+	std::mt19937 rng(4);
+	std::uniform_int_distribution<int> variable(1, static_cast<int>(numvar));
+	std::vector<int> common;
+	std::vector<std::vector<int>> sets(queries);
+
+	for(std::size_t i = 0; i < prefix; ++i)
+		common.emplace_back(rng() & 1 ? variable(rng) : -variable(rng));
+
+	for(std::vector<int> &assumptions : sets)
+	{
+		assumptions = common;
+		assumptions.emplace_back(rng() & 1 ? variable(rng) : -variable(rng));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	propagate_assumption_sets(store, sets, 1);
+	auto scalar = std::chrono::steady_clock::now();
+	propagate_assumption_sets_bitparallel<1>(store, sets);
+	auto lanes64 = std::chrono::steady_clock::now();
+	propagate_assumption_sets_bitparallel<4>(store, sets);
+	auto lanes256 = std::chrono::steady_clock::now();
+
+	std::printf("%8zu vars %6zu queries, prefix %3zu: scalar %10.0f queries/s, 64 lanes %10.0f queries/s, 256 lanes %10.0f queries/s\n", numvar, queries, prefix,
+		static_cast<double>(queries) / std::chrono::duration<double>(scalar - start).count(),
+		static_cast<double>(queries) / std::chrono::duration<double>(lanes64 - scalar).count(),
+		static_cast<double>(queries) / std::chrono::duration<double>(lanes256 - lanes64).count());
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t scale = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1;
+
+	run(1000, 2000 * scale);
+	run(10000, 200 * scale);
+	run(100000, 20 * scale);
+	run(1000000, 2 * scale);
+
+	run_batch(10000, 200 * scale, 1);
+	run_batch(10000, 200 * scale, 4);
+
+	run_bitparallel(10000, 4096 * scale, 0);
+	run_bitparallel(10000, 4096 * scale, 40);
+	return 0;
+}
@@ -0,0 +1,59 @@
+#!/bin/bash
+
+# Usage: check_drat.sh [CNF]
+# Checks drat-check on an UNSAT instance (default test/benchmarks/php-7.cnf): the proof MiniSat core
+# writes with -drat has to be verified and kept as well-formed LRAT ending in the empty clause, and a
+# proof claiming the empty clause right away has to be rejected without any LRAT written.
+
+TEST=`cd \`dirname $0\` && pwd`
+CNF=${1:-$TEST/benchmarks/php-7.cnf}
+export MROOT=$TEST/../src/minisat
+# the MiniSat sources predate the narrowing checks of current compilers
+export CFLAGS="-Wall -Wno-parentheses -fpermissive"
+
+make -s -C $MROOT/core || exit 1
+make -s -C $MROOT/drat || exit 1
+
+TMP=`mktemp -d`
+trap "rm -rf $TMP" EXIT
+
+fail() { echo "FAILED: $1"; exit 1; }
+
+$MROOT/core/minisat -verb=0 $CNF -drat=$TMP/proof.drat > /dev/null
+[ $? = 20 ] || fail "MiniSat did not answer UNSAT on $CNF"
+
+# the proof MiniSat wrote
+$MROOT/drat/drat-check -verb=0 $CNF $TMP/proof.drat -lrat=$TMP/proof.lrat > $TMP/out
+[ $? = 0 ] && grep -qx "s VERIFIED" $TMP/out || fail "the proof of MiniSat was not verified"
+
+# the LRAT: additions "id literals 0 hints 0" with ids increasing past the formula's clauses and hints
+# only to earlier clauses, deletions "id d ids 0" of clauses up to the last added; the empty clause last
+CLAUSES=`awk '$1 == "p" { print $4; exit }' $CNF`
+awk -v id=$CLAUSES '
+	function abs(x) { return x < 0 ? -x : x }
+	$NF != 0 { bad = 1 }
+	$2 == "d" {
+		if ($1 != id) bad = 1
+		for (i = 3; i < NF; ++i)
+			if ($i <= 0 || $i > id) bad = 1
+		next
+	}
+	{
+		if ($1 <= id) bad = 1
+		id = $1
+		for (i = 2; i < NF && $i != 0; ++i)
+			;
+		if (i == NF) bad = 1
+		empty = i == 2
+		for (++i; i < NF; ++i)
+			if ($i == 0 || abs($i) >= id) bad = 1
+	}
+	END { exit bad || !empty }' $TMP/proof.lrat || fail "the LRAT of the proof is malformed"
+
+# a proof claiming the empty clause, which unit propagation does not give
+printf 'a\000' > $TMP/wrong.drat
+$MROOT/drat/drat-check -verb=0 $CNF $TMP/wrong.drat -lrat=$TMP/wrong.lrat > $TMP/out
+[ $? = 1 ] && grep -qx "s NOT VERIFIED" $TMP/out || fail "a wrong proof was verified"
+[ -e $TMP/wrong.lrat ] && fail "an LRAT was written for a wrong proof"
+
+echo "drat-check: `grep -c . $TMP/proof.lrat` LRAT lines verified on `basename $CNF`, a wrong proof rejected"
@@ -1,23 +1,24 @@
 #!/bin/bash
 
+# Writes the instance table of the benchmark tests (declared in src/benchmark_test.h) from
+# benchmarks/MANIFEST into the given file.
+
 TEST_PATH=`pwd`
-BENCHMARKS=$(ls benchmarks | sed 's:\(\<.*\>\):"'"$TEST_PATH"'\/benchmarks\/\1":g' | tr "\n" "," | sed 's/,$//')
+BENCHMARKS=$(awk -v dir="$TEST_PATH/benchmarks" '
+	/^#/ || NF == 0 { next }
+	$2 != "SAT" && $2 != "UNSAT" || NF != 3 { print "benchmarks/MANIFEST:" NR ": expected instance SAT|UNSAT budget" > "/dev/stderr"; exit 1 }
+	{ printf "\t\t{\"%s/%s\", %s, %s},\n", dir, $1, $2 == "SAT" ? "true" : "false", $3 }' benchmarks/MANIFEST) || exit 1
 
 cat << EOF > $1
 
-#include "gtest/gtest.h"
-#include <iostream>
-#include <string>
-
-using namespace std;
-
-struct BenchmarkTest : public ::testing::TestWithParam<const char*>
-{};
+#include "benchmark_test.h"
 
-TEST_P(BenchmarkTest, test_0)
+const std::vector<Benchmark> &benchmarks()
 {
-    cerr << GetParam() << endl;
-}
+	static const std::vector<Benchmark> manifest = {
+$BENCHMARKS
+	};
 
-INSTANTIATE_TEST_CASE_P(T1, BenchmarkTest, ::testing::Values($BENCHMARKS));
+	return manifest;
+}
 EOF
@@ -0,0 +1,39 @@
+#!/bin/bash
+
+# Usage: gen_instances.sh DIR [MAX_CLAUSES]
+# Writes a size sweep of every generated family into DIR: for each power of ten from 10 up to
+# MAX_CLAUSES (default 100000, at most 10000000) one instance of roughly that many clauses, seed 1.
+
+DIR=${1:?usage: $0 DIR [MAX_CLAUSES]}
+MAX=${2:-100000}
+GEN=`dirname $0`/bin/gen.x
+
+mkdir -p $DIR
+
+# the size parameter giving about $1 clauses, from the clause count of each family
+size() { awk "BEGIN { s = $2; if (s < $3) s = $3; printf \"%d\", s }" /dev/null; }
+
+for ((clauses = 10; clauses <= MAX && clauses <= 10000000; clauses *= 10))
+do
+	n=`size $clauses "$clauses / 4.26" 5`
+	$GEN ksat 3 $n > $DIR/ksat3-$clauses.cnf
+
+	n=`size $clauses "$clauses / 9.93" 6`
+	$GEN ksat 4 $n > $DIR/ksat4-$clauses.cnf
+
+	# holes^2 (holes + 1) / 2 clauses
+	n=`size $clauses "exp(log(2 * $clauses) / 3)" 1`
+	$GEN php $n > $DIR/php-$clauses.cnf
+
+	# 1 + 3 + 3 * 4.6 / 2 clauses per vertex
+	n=`size $clauses "$clauses / 10.9" 1`
+	$GEN coloring $n 3 > $DIR/coloring3-$clauses.cnf
+
+	# two XORs of 4 clauses per variable
+	n=`size $clauses "$clauses / 8" 2`
+	$GEN parity $n > $DIR/parity-$clauses.cnf
+
+	# about 17 clauses per partial product: an AND and a full adder
+	n=`size $clauses "sqrt($clauses / 17)" 2`
+	$GEN factor $n > $DIR/factor-$clauses.cnf
+done
@@ -1,6 +0,0 @@
-#include "gtest/gtest.h"
-
-TEST(basic_test, test1)
-{
-    // TODO : implement some tests          
-}
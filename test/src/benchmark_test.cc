@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "benchmark_test.h"
+#include "cnf/dimacs.h"
+#include "cnf/model_check.h"
+#include "search.h"
+#include "unit_propagation.h"
+
+/**
+ * Solves every instance of the manifest in-process with each search configuration. The answer has to
+ * match the manifest's, which was recorded from MiniSat when the instance was added: MiniSat is the
+ * reference for UNSAT answers, but it is not run here. A model has to satisfy every clause as read
+ * from the file, and the solve has to finish within the instance's budget, so that a performance
+ * regression fails the build.
+ */
+
+void PrintTo(const Benchmark &benchmark, std::ostream *os)
+{
+	*os << benchmark.path;
+}
+
+struct BenchmarkTest : public ::testing::TestWithParam<Benchmark>
+{
+	void solve(const SearchOptions &options);
+};
+
+void BenchmarkTest::solve(const SearchOptions &options)
+{
+	const Benchmark &benchmark = GetParam();
+	DimacsFormula formula;
+	std::string error;
+
+	ASSERT_TRUE(read_dimacs(benchmark.path, formula, error)) << error;
+
+	std::shared_ptr<const ClauseStore> store = std::make_shared<const ClauseStore>(formula.literals, formula.offsets, formula.numvar);
+	std::vector<std::uint8_t> model;
+	SearchStats stats;
+
+	auto start = std::chrono::steady_clock::now();
+	bool satisfiable = solve_formula(store, options, model, stats);
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ(benchmark.satisfiable, satisfiable);
+	EXPECT_LE(elapsed, benchmark.budget) << stats.decisions << " decisions, " << stats.conflicts << " conflicts";
+
+	if(!satisfiable)
+		return;
+
+	ASSERT_EQ(formula.numvar + 1, model.size());
+
+	ModelBits bits(formula.numvar);
+	ModelCheck check;
+
+	for(std::size_t v = 1; v <= formula.numvar; ++v)
+		bits.set(model[v] ? static_cast<int>(v) : -static_cast<int>(v));
+
+	ASSERT_TRUE(check_dimacs_model(benchmark.path, bits, 2, check, error)) << error;
+	EXPECT_EQ(formula.size(), check.clauses);
+	EXPECT_EQ(0u, check.falsified) << "the model falsifies clause " << check.first_falsified;
+}
+
+TEST_P(BenchmarkTest, dpll)
+{
+	solve(SearchOptions());
+}
+
+TEST_P(BenchmarkTest, dpll_jw_pure_literals)
+{
+	SearchOptions options;
+	options.heuristic = "jw";
+	options.pure_literals = true;
+	solve(options);
+}
+
+TEST_P(BenchmarkTest, dpll_parallel)
+{
+	SearchOptions options;
+	options.heuristic = "moms";
+	options.threads = 4;
+	solve(options);
+}
+
+TEST_P(BenchmarkTest, cdcl)
+{
+	SearchOptions options;
+	options.learning = true;
+	solve(options);
+}
+
+INSTANTIATE_TEST_CASE_P(Manifest, BenchmarkTest, ::testing::ValuesIn(benchmarks()));
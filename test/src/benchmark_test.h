@@ -0,0 +1,18 @@
+#ifndef _BENCHMARK_TEST
+#define _BENCHMARK_TEST
+
+#include <vector>
+
+// One line of benchmarks/MANIFEST.
+struct Benchmark {
+	const char *path;
+	bool satisfiable;
+	// seconds of wall time each configuration may take
+	double budget;
+};
+
+// Generated from the manifest by gen_benchmark_tests.sh.
+const std::vector<Benchmark> &benchmarks();
+
+
+#endif
@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bit_propagation.h"
+#include "random_formula.h"
+#include "unit_propagation.h"
+
+/**
+ * The bit-parallel propagator has to be a drop-in for propagate_assumption_sets: the same conflicts
+ * and the same implied literals (in any order) for every assumption set, at either lane width.
+ */
+
+static void expect_same_results(const std::vector<AssumptionResult> &expected, const std::vector<AssumptionResult> &actual, const char *kernel)
+{
+	ASSERT_EQ(expected.size(), actual.size()) << kernel;
+
+	for(std::size_t i = 0; i < expected.size(); ++i)
+	{
+		std::vector<int> expected_implied = expected[i].implied;
+		std::vector<int> actual_implied = actual[i].implied;
+		std::sort(expected_implied.begin(), expected_implied.end());
+		std::sort(actual_implied.begin(), actual_implied.end());
+
+		EXPECT_EQ(expected[i].conflict, actual[i].conflict) << kernel << ", set " << i;
+		EXPECT_EQ(expected_implied, actual_implied) << kernel << ", set " << i;
+	}
+}
+
+TEST(BitPropagatorTest, matches_scalar_propagation)
+{
+	std::mt19937 random(9);
+
+	for(int round = 0; round < 30; ++round)
+	{
+		std::size_t numvar = 10 + 10 * static_cast<std::size_t>(round);
+		std::shared_ptr<const ClauseStore> store = std::make_shared<const ClauseStore>(random_formula(numvar, 2 * numvar, random), numvar);
+		// more sets than the 256 lanes of the wide kernel, so that both take several passes
+		std::vector<std::vector<int>> sets = random_assumption_sets(numvar, 300, 6, random);
+
+		std::vector<AssumptionResult> expected = propagate_assumption_sets(store, sets);
+		SCOPED_TRACE(round);
+		expect_same_results(expected, propagate_assumption_sets_bitparallel<1>(store, sets), "64 lanes");
+		expect_same_results(expected, propagate_assumption_sets_bitparallel<4>(store, sets), "256 lanes");
+	}
+}
+
+TEST(BitPropagatorTest, conflict_at_root)
+{
+	std::shared_ptr<const ClauseStore> store = std::make_shared<const ClauseStore>(std::vector<std::vector<int>>({{1, 2}, {-1}, {-2}}), 2);
+	std::vector<std::vector<int>> sets = {{1}, {2}, {-1, -2}};
+
+	std::vector<AssumptionResult> expected = propagate_assumption_sets(store, sets);
+	expect_same_results(expected, propagate_assumption_sets_bitparallel<1>(store, sets), "64 lanes");
+	expect_same_results(expected, propagate_assumption_sets_bitparallel<4>(store, sets), "256 lanes");
+	for(const AssumptionResult &result : expected)
+		EXPECT_TRUE(result.conflict);
+}
+
+TEST(BitPropagatorTest, checkpoint_and_rollback)
+{
+	std::shared_ptr<const ClauseStore> store = std::make_shared<const ClauseStore>(std::vector<std::vector<int>>({{-1, 2}, {-2, 3}, {-3, -4}, {4, 5, 6}}), 6);
+	BitPropagator<4> propagator(store);
+
+	// lane 0 implies 2, 3 and -4, lane 200 just -4
+	propagator.assign(1, 0);
+	propagator.assign(3, 200);
+	EXPECT_FALSE(propagator.propagate().any());
+	EXPECT_TRUE(propagator.true_lanes(3).test(0));
+	EXPECT_TRUE(propagator.false_lanes(4).test(200));
+	propagator.checkpoint();
+	EXPECT_TRUE(propagator.changed().empty());
+
+	// lane 1 runs into a conflict, lane 200 implies 6 over 4 5 6
+	propagator.assign(1, 1);
+	propagator.assign(4, 1);
+	propagator.assign(-5, 200);
+	BitPropagator<4>::Mask conflict = propagator.propagate();
+	EXPECT_TRUE(conflict.test(1));
+	EXPECT_FALSE(conflict.test(0));
+	EXPECT_FALSE(conflict.test(200));
+	EXPECT_TRUE(propagator.true_lanes(6).test(200));
+	EXPECT_FALSE(propagator.changed().empty());
+
+	// back to the checkpoint: the lanes assigned before it are kept, the others are free again
+	propagator.rollback();
+	EXPECT_TRUE(propagator.changed().empty());
+	for(std::size_t v = 1; v <= 6; ++v)
+	{
+		BitPropagator<4>::Mask assigned = propagator.true_lanes(v) | propagator.false_lanes(v);
+		EXPECT_FALSE(assigned.test(1)) << "variable " << v;
+		EXPECT_EQ(v <= 4, assigned.test(0)) << "variable " << v;
+		EXPECT_EQ(v == 3 || v == 4, assigned.test(200)) << "variable " << v;
+	}
+	EXPECT_FALSE(propagator.true_lanes(6).test(200));
+
+	// and propagation goes on from there
+	propagator.assign(-6, 200);
+	propagator.assign(-5, 200);
+	EXPECT_TRUE(propagator.propagate().test(200));
+}
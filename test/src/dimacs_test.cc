@@ -0,0 +1,181 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <zlib.h>
+
+#include "cnf/dimacs.h"
+
+/**
+ * The shared DIMACS loader on small files written for each test: what it reads from well-formed input,
+ * plain or gzipped, and how it reports malformed input.
+ */
+
+// A file in the temporary directory holding the given text, gzip-compressed if asked; removed again
+// at the end of the test.
+class TemporaryFile {
+	std::string _path;
+
+public:
+	explicit TemporaryFile(const std::string &text, bool compressed = false)
+	{
+		char path[] = "/tmp/dimacs_test_XXXXXX";
+		int fd = mkstemp(path);
+		_path = path;
+
+		if(compressed)
+		{
+			gzFile stream = gzdopen(fd, "wb");
+			gzwrite(stream, text.data(), static_cast<unsigned>(text.size()));
+			gzclose(stream);
+		}
+		else
+		{
+			EXPECT_EQ(static_cast<ssize_t>(text.size()), write(fd, text.data(), text.size()));
+			close(fd);
+		}
+	}
+
+	~TemporaryFile() { unlink(_path.c_str()); }
+
+	const char *path() const { return _path.c_str(); }
+};
+
+static std::vector<std::vector<int>> clauses(const std::vector<int> &literals, const std::vector<std::uint32_t> &offsets)
+{
+	std::vector<std::vector<int>> result;
+	for(std::size_t c = 0; c + 1 < offsets.size(); ++c)
+		result.emplace_back(literals.begin() + offsets[c], literals.begin() + offsets[c + 1]);
+	return result;
+}
+
+static const char *example = "c an example\nc\np cnf 4 3\n1 -2 0 3\n4 -1 0\n-4 0\n";
+
+TEST(DimacsTest, reads_clauses)
+{
+	TemporaryFile file(example);
+	DimacsFormula formula;
+	std::string error;
+
+	ASSERT_TRUE(read_dimacs(file.path(), formula, error)) << error;
+	EXPECT_EQ(4u, formula.numvar);
+	EXPECT_EQ(3u, formula.size());
+	EXPECT_EQ(std::vector<std::vector<int>>({{1, -2}, {3, 4, -1}, {-4}}), clauses(formula.literals, formula.offsets));
+}
+
+TEST(DimacsTest, reads_gzip)
+{
+	TemporaryFile file(example, true);
+	DimacsFormula formula;
+	std::string error;
+
+	ASSERT_TRUE(read_dimacs(file.path(), formula, error)) << error;
+	EXPECT_EQ(4u, formula.numvar);
+	EXPECT_EQ(std::vector<std::vector<int>>({{1, -2}, {3, 4, -1}, {-4}}), clauses(formula.literals, formula.offsets));
+}
+
+TEST(DimacsTest, stops_at_percent)
+{
+	// the SATLIB convention: what follows % is not part of the formula
+	TemporaryFile complete("p cnf 2 2\n1 2 0\n-1 0\n%\n0\n");
+	TemporaryFile truncated("p cnf 2 3\n1 2 0\n-1 0\n%\n0\n2 0\n");
+	DimacsFormula formula;
+	std::string error;
+
+	ASSERT_TRUE(read_dimacs(complete.path(), formula, error)) << error;
+	EXPECT_EQ(std::vector<std::vector<int>>({{1, 2}, {-1}}), clauses(formula.literals, formula.offsets));
+
+	EXPECT_FALSE(read_dimacs(truncated.path(), formula, error));
+	EXPECT_EQ("Expected 3 clauses, found 2", error);
+}
+
+TEST(DimacsTest, missing_header)
+{
+	TemporaryFile clauses_only("c no header\n1 2 0\n");
+	TemporaryFile comments_only("c nothing but a comment\n");
+	DimacsFormula formula;
+	std::string error;
+
+	EXPECT_FALSE(read_dimacs(clauses_only.path(), formula, error));
+	EXPECT_EQ(0u, error.find("Expected a p cnf header")) << error;
+
+	EXPECT_FALSE(read_dimacs(comments_only.path(), formula, error));
+	EXPECT_EQ("Missing p cnf header", error);
+}
+
+TEST(DimacsTest, literal_out_of_range)
+{
+	TemporaryFile file("p cnf 3 2\n1 2 0\n-3 4 0\n");
+	DimacsFormula formula;
+	std::string error;
+
+	EXPECT_FALSE(read_dimacs(file.path(), formula, error));
+	EXPECT_EQ(0u, error.find("Bad or out-of-range literal in clause 2")) << error;
+}
+
+TEST(DimacsTest, too_few_clauses)
+{
+	TemporaryFile file("p cnf 3 4\n1 2 0\n-3 0\n2");
+	DimacsFormula formula;
+	std::string error;
+
+	EXPECT_FALSE(read_dimacs(file.path(), formula, error));
+	EXPECT_EQ("Expected 4 clauses, found 2", error);
+}
+
+TEST(DimacsTest, too_many_clauses)
+{
+	// dropping the clause after the announced one would make this formula satisfiable
+	TemporaryFile extra_clause("p cnf 1 1\n1 0\n-1 0\n");
+	TemporaryFile extra_literals("p cnf 2 1\n1 0\n-1 2");
+	TemporaryFile trailing_comment("p cnf 2 1\n1 -2 0\nc the end\n");
+	DimacsFormula formula;
+	std::string error;
+
+	EXPECT_FALSE(read_dimacs(extra_clause.path(), formula, error));
+	EXPECT_EQ("Expected 1 clauses, found more", error);
+
+	EXPECT_FALSE(read_dimacs(extra_literals.path(), formula, error));
+	EXPECT_EQ("Expected 1 clauses, found more", error);
+
+	ASSERT_TRUE(read_dimacs(trailing_comment.path(), formula, error)) << error;
+	EXPECT_EQ(std::vector<std::vector<int>>({{1, -2}}), clauses(formula.literals, formula.offsets));
+}
+
+TEST(DimacsTest, missing_file)
+{
+	DimacsFormula formula;
+	std::string error;
+
+	EXPECT_FALSE(read_dimacs("/nonexistent/formula.cnf", formula, error));
+	EXPECT_EQ(0u, error.find("Cannot open /nonexistent/formula.cnf")) << error;
+}
+
+TEST(DimacsTest, remove_redundancy)
+{
+	// duplicates go, tautologies go altogether, the rest is compacted in order
+	std::vector<std::vector<int>> input = {{1, 1, 2}, {1, -1, 3}, {-2, -2}, {3, 2, -3, 4}, {4}, {2, -4, 2, -4, 1}};
+	std::vector<int> literals;
+	std::vector<std::uint32_t> offsets(1, 0);
+	for(const std::vector<int> &clause : input)
+	{
+		literals.insert(literals.end(), clause.begin(), clause.end());
+		offsets.push_back(static_cast<std::uint32_t>(literals.size()));
+	}
+
+	remove_redundancy(4, literals, offsets);
+	EXPECT_EQ(std::vector<std::vector<int>>({{1, 2}, {-2}, {4}, {2, -4, 1}}), clauses(literals, offsets));
+	EXPECT_EQ(7u, literals.size());
+	EXPECT_EQ(5u, offsets.size());
+
+	// nothing left when every clause is a tautology
+	literals = {1, -1, -2, 2};
+	offsets = {0, 2, 4};
+	remove_redundancy(2, literals, offsets);
+	EXPECT_TRUE(literals.empty());
+	EXPECT_EQ(std::vector<std::uint32_t>({0}), offsets);
+}
@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "cnf/dimacs.h"
+#include "cnf/model_check.h"
+
+/**
+ * The model checker against falsifying models: the number of falsified clauses and the index of the
+ * first have to come out the same whatever the number of threads, also when a falsified clause is
+ * split across the line-aligned chunks that the threads check on their own.
+ */
+
+static std::string temporary_path()
+{
+	char path[] = "/tmp/model_check_test_XXXXXX";
+	close(mkstemp(path));
+	return path;
+}
+
+static void write_file(const std::string &path, const std::string &text)
+{
+	std::FILE *out = std::fopen(path.c_str(), "wb");
+	ASSERT_NE(nullptr, out);
+	ASSERT_EQ(text.size(), std::fwrite(text.data(), 1, text.size(), out));
+	std::fclose(out);
+}
+
+// Clauses of three literals, one literal per line, each written with a sign slot in front of its first
+// literal: a blank keeps it positive, so that a model making every variable true satisfies the clause,
+// and a minus falsifies it without moving any other byte of the file.
+struct SplitClauses {
+	std::string text;
+	std::size_t body;
+	std::vector<std::size_t> begin;
+	std::vector<std::size_t> sign;
+
+	explicit SplitClauses(std::size_t numclause)
+	{
+		std::string header = "p cnf 1000 " + std::to_string(numclause) + "\n";
+		text = header;
+		body = header.size();
+
+		for(std::size_t c = 0; c < numclause; ++c)
+		{
+			begin.push_back(text.size());
+			sign.push_back(text.size());
+			text += " " + std::to_string(c % 1000 + 1) + "\n";
+			text += "-" + std::to_string((c * 7) % 1000 + 1) + "\n";
+			text += "-" + std::to_string((c * 13) % 1000 + 1) + " 0\n";
+		}
+	}
+
+	// The clause holding the byte at the given fraction of the clauses' text.
+	std::size_t clause_at(std::size_t numerator, std::size_t denominator) const
+	{
+		std::size_t offset = body + (text.size() - body) * numerator / denominator;
+		std::size_t c = 0;
+		while(c + 1 < begin.size() && begin[c + 1] <= offset)
+			++c;
+		return c;
+	}
+
+	void falsify(std::size_t c) { text[sign[c]] = '-'; }
+	void satisfy(std::size_t c) { text[sign[c]] = ' '; }
+};
+
+static void expect_check(const std::string &path, const ModelBits &model, std::size_t clauses, std::size_t falsified, std::size_t first)
+{
+	for(std::size_t threads : {1, 4, 16})
+	{
+		ModelCheck check;
+		std::string error;
+
+		ASSERT_TRUE(check_dimacs_model(path.c_str(), model, threads, check, error)) << error;
+		EXPECT_EQ(clauses, check.clauses) << threads << " threads";
+		EXPECT_EQ(falsified, check.falsified) << threads << " threads";
+		EXPECT_EQ(first, check.first_falsified) << threads << " threads";
+	}
+}
+
+TEST(ModelCheckTest, falsified_across_chunks)
+{
+	// over 16 MB of clauses, so that 16 threads get a chunk of their own
+	const std::size_t numclause = 1100000;
+	SplitClauses formula(numclause);
+	ASSERT_GT(formula.text.size() - formula.body, std::size_t(16) << 20);
+
+	ModelBits model(1000);
+	for(int v = 1; v <= 1000; ++v)
+		model.set(v);
+
+	std::string path = temporary_path();
+
+	// the clauses where the chunks of 4 and of 16 threads meet, all at once
+	std::vector<std::size_t> boundaries;
+	for(std::size_t k = 1; k < 16; ++k)
+		boundaries.push_back(formula.clause_at(k, 16));
+	for(std::size_t c : boundaries)
+		formula.falsify(c);
+	write_file(path, formula.text);
+	expect_check(path, model, numclause, boundaries.size(), boundaries[0]);
+
+	// the same through the in-memory checker
+	DimacsFormula loaded;
+	std::string error;
+	ASSERT_TRUE(read_dimacs(path.c_str(), loaded, error)) << error;
+	for(std::size_t threads : {1, 4, 16})
+	{
+		ModelCheck check = check_model(loaded, model, threads);
+		EXPECT_EQ(boundaries.size(), check.falsified) << threads << " threads";
+		EXPECT_EQ(boundaries[0], check.first_falsified) << threads << " threads";
+	}
+	for(std::size_t c : boundaries)
+		formula.satisfy(c);
+
+	// one at a time at the boundaries of 4 threads, at either side of each, and at the very end
+	std::vector<std::size_t> targets;
+	for(std::size_t k = 1; k < 4; ++k)
+	{
+		targets.push_back(formula.clause_at(k, 4));
+		targets.push_back(formula.clause_at(k, 4) + 1);
+	}
+	targets.push_back(numclause - 1);
+
+	for(std::size_t c : targets)
+	{
+		formula.falsify(c);
+		write_file(path, formula.text);
+		expect_check(path, model, numclause, 1, c);
+		formula.satisfy(c);
+	}
+
+	// and none
+	write_file(path, formula.text);
+	expect_check(path, model, numclause, 0, numclause);
+
+	unlink(path.c_str());
+}
+
+TEST(ModelCheckTest, read_model)
+{
+	std::string path = temporary_path();
+	ModelBits model;
+	std::string error;
+
+	write_file(path, "c a comment\ns SATISFIABLE\nv 1 -2\nv 3 0\n");
+	ASSERT_TRUE(read_model(path.c_str(), model, error)) << error;
+	EXPECT_TRUE(model.is_true(1));
+	EXPECT_TRUE(model.is_true(-2));
+	EXPECT_TRUE(model.is_true(3));
+	EXPECT_FALSE(model.is_true(-1));
+	EXPECT_FALSE(model.is_true(4));
+	EXPECT_FALSE(model.is_true(-4));
+
+	// a MiniSat result file
+	write_file(path, "SAT\n-1 2 0\n");
+	ASSERT_TRUE(read_model(path.c_str(), model, error)) << error;
+	EXPECT_TRUE(model.is_true(-1));
+	EXPECT_TRUE(model.is_true(2));
+
+	write_file(path, "s UNSATISFIABLE\n");
+	EXPECT_FALSE(read_model(path.c_str(), model, error));
+
+	write_file(path, "v 1 2 -1 0\n");
+	EXPECT_FALSE(read_model(path.c_str(), model, error));
+
+	unlink(path.c_str());
+}
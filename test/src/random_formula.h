@@ -0,0 +1,60 @@
+#ifndef _RANDOM_FORMULA
+#define _RANDOM_FORMULA
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// A random formula of mostly binary and ternary clauses, with a few wider ones so that every clause
+// kind of the propagators is exercised; literals of a clause are over distinct variables.
+inline std::vector<std::vector<int>> random_formula(std::size_t numvar, std::size_t numclause, std::mt19937 &random)
+{
+	static const std::size_t widths[] = {2, 2, 2, 3, 3, 3, 4, 5};
+	std::uniform_int_distribution<std::size_t> width(0, sizeof(widths) / sizeof(widths[0]) - 1);
+	std::uniform_int_distribution<int> variable(1, static_cast<int>(numvar));
+	std::vector<std::vector<int>> clauses(numclause);
+
+	for(std::vector<int> &clause : clauses)
+	{
+		std::size_t size = std::min(widths[width(random)], numvar);
+		while(clause.size() < size)
+		{
+			int v = variable(random);
+			bool fresh = true;
+			for(int literal : clause)
+				fresh = fresh && literal != v && literal != -v;
+			if(fresh)
+				clause.push_back(random() & 1 ? v : -v);
+		}
+	}
+
+	return clauses;
+}
+
+// Random sets of one to max_size assumption literals over distinct variables.
+inline std::vector<std::vector<int>> random_assumption_sets(std::size_t numvar, std::size_t count, std::size_t max_size, std::mt19937 &random)
+{
+	std::uniform_int_distribution<std::size_t> size(1, max_size);
+	std::uniform_int_distribution<int> variable(1, static_cast<int>(numvar));
+	std::vector<std::vector<int>> sets(count);
+
+	for(std::vector<int> &set : sets)
+	{
+		std::size_t target = std::min(size(random), numvar);
+		while(set.size() < target)
+		{
+			int v = variable(random);
+			bool fresh = true;
+			for(int literal : set)
+				fresh = fresh && literal != v && literal != -v;
+			if(fresh)
+				set.push_back(random() & 1 ? v : -v);
+		}
+	}
+
+	return sets;
+}
+
+
+#endif
@@ -0,0 +1,200 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "random_formula.h"
+#include "unit_propagation.h"
+
+/**
+ * Unit tests of UnitPropagator on small formulas whose outcome can be worked out by hand.
+ */
+
+static std::vector<std::vector<int>> residual_clauses(const ResidualFormula &output)
+{
+	std::vector<std::vector<int>> clauses;
+	for(std::size_t c = 0; c < output.size(); ++c)
+		clauses.emplace_back(output.literals.begin() + output.offsets[c], output.literals.begin() + output.offsets[c + 1]);
+	return clauses;
+}
+
+TEST(UnitPropagatorTest, produce_output_after_assign)
+{
+	UnitPropagator propagator({{1, 2}, {-1, 3, 4}, {-1, -2}, {2, 5, 6}, {5, -6, 7}}, 7);
+	ASSERT_TRUE(propagator.propagate());
+	ASSERT_TRUE(propagator.assign(1));
+
+	// 1 satisfies the first clause and implies -2, which satisfies the third; -1 and 2 are stripped
+	ResidualFormula output;
+	propagator.produce_output(output);
+
+	EXPECT_EQ(std::vector<int>({1, -2}), output.units);
+	EXPECT_EQ(std::vector<std::vector<int>>({{3, 4}, {5, 6}, {5, -6, 7}}), residual_clauses(output));
+
+	// a second call rewrites the same buffers
+	const int *literals = output.literals.data();
+	const std::uint32_t *offsets = output.offsets.data();
+	const int *units = output.units.data();
+	propagator.produce_output(output);
+
+	EXPECT_EQ(literals, output.literals.data());
+	EXPECT_EQ(offsets, output.offsets.data());
+	EXPECT_EQ(units, output.units.data());
+	EXPECT_EQ(std::vector<int>({1, -2}), output.units);
+	EXPECT_EQ(std::vector<std::vector<int>>({{3, 4}, {5, 6}, {5, -6, 7}}), residual_clauses(output));
+}
+
+TEST(UnitPropagatorTest, produce_output_at_root)
+{
+	UnitPropagator propagator({{1, 2}, {-2}, {2, 3, -1, 4}}, 4);
+	ASSERT_TRUE(propagator.propagate());
+
+	// the unit clause -2 implies 1 and is satisfied itself
+	ResidualFormula output;
+	propagator.produce_output(output);
+
+	EXPECT_EQ(std::vector<int>({-2, 1}), output.units);
+	EXPECT_EQ(std::vector<std::vector<int>>({{3, 4}}), residual_clauses(output));
+}
+
+static std::vector<int> sorted(std::vector<int> literals)
+{
+	std::sort(literals.begin(), literals.end());
+	return literals;
+}
+
+TEST(UnitPropagatorTest, propagate_assumptions_chain)
+{
+	UnitPropagator propagator({{-1, 2}, {-2, 3}, {-3, 4}, {-4, -5, 6}, {7, 8}}, 8);
+	AssumptionResult result;
+
+	ASSERT_TRUE(propagator.propagate_assumptions({1}, result));
+	EXPECT_FALSE(result.conflict);
+	EXPECT_EQ(std::vector<int>({2, 3, 4}), sorted(result.implied));
+
+	// the assumptions are not repeated among the literals they imply
+	ASSERT_TRUE(propagator.propagate_assumptions({5, 1}, result));
+	EXPECT_EQ(std::vector<int>({2, 3, 4, 6}), sorted(result.implied));
+
+	// every set starts from the root again
+	ASSERT_TRUE(propagator.propagate_assumptions({-7}, result));
+	EXPECT_EQ(std::vector<int>({8}), result.implied);
+	EXPECT_EQ(0u, propagator.decision_level());
+	EXPECT_TRUE(propagator.trail().empty());
+}
+
+TEST(UnitPropagatorTest, propagate_assumptions_conflict)
+{
+	UnitPropagator propagator({{-1, 2}, {-2, 3}, {-3, 4}, {-4, -5, 6}}, 6);
+	AssumptionResult result;
+
+	EXPECT_FALSE(propagator.propagate_assumptions({1, -4}, result));
+	EXPECT_TRUE(result.conflict);
+	EXPECT_FALSE(propagator.propagate_assumptions({1, 5, -6}, result));
+	EXPECT_TRUE(result.conflict);
+	EXPECT_FALSE(propagator.propagate_assumptions({3, -3}, result));
+	EXPECT_TRUE(result.conflict);
+
+	// a conflict leaves nothing behind for the next set
+	EXPECT_TRUE(propagator.propagate_assumptions({5, -6}, result));
+	EXPECT_FALSE(result.conflict);
+	EXPECT_EQ(std::vector<int>({-4, -3, -2, -1}), sorted(result.implied));
+}
+
+// Unit propagation the slow way, independent of the watch lists: sweeps every clause until none is
+// unit any more. Sets conflict, or leaves the literals implied beyond the assumptions, sorted.
+static AssumptionResult naive_propagation(const std::vector<std::vector<int>> &clauses, std::size_t numvar, const std::vector<int> &assumptions)
+{
+	std::vector<int> value(numvar + 1, 0);
+	AssumptionResult result;
+
+	for(int literal : assumptions)
+	{
+		int v = std::abs(literal);
+		result.conflict = result.conflict || value[v] == (literal < 0 ? 1 : -1);
+		value[v] = literal < 0 ? -1 : 1;
+	}
+
+	for(bool changed = true; changed && !result.conflict; )
+	{
+		changed = false;
+		for(const std::vector<int> &clause : clauses)
+		{
+			int unassigned = 0, free_literal = 0;
+			bool satisfied = false;
+			for(int literal : clause)
+			{
+				int v = value[std::abs(literal)];
+				satisfied = satisfied || v == (literal < 0 ? -1 : 1);
+				if(v == 0)
+				{
+					++unassigned;
+					free_literal = literal;
+				}
+			}
+
+			if(satisfied || unassigned > 1)
+				continue;
+			if(unassigned == 0)
+			{
+				result.conflict = true;
+				break;
+			}
+			value[std::abs(free_literal)] = free_literal < 0 ? -1 : 1;
+			result.implied.push_back(free_literal);
+			changed = true;
+		}
+	}
+
+	if(result.conflict)
+		result.implied.clear();
+	std::sort(result.implied.begin(), result.implied.end());
+	return result;
+}
+
+TEST(UnitPropagatorTest, propagate_assumption_sets_threads)
+{
+	std::mt19937 random(8);
+
+	for(int round = 0; round < 20; ++round)
+	{
+		std::size_t numvar = 20 + 10 * static_cast<std::size_t>(round);
+		std::vector<std::vector<int>> clauses = random_formula(numvar, 2 * numvar, random);
+		std::shared_ptr<const ClauseStore> store = std::make_shared<const ClauseStore>(clauses, numvar);
+		std::vector<std::vector<int>> sets = random_assumption_sets(numvar, 200, 6, random);
+
+		std::vector<AssumptionResult> single = propagate_assumption_sets(store, sets, 1);
+		std::vector<AssumptionResult> parallel = propagate_assumption_sets(store, sets, 4);
+		ASSERT_EQ(sets.size(), single.size());
+		ASSERT_EQ(sets.size(), parallel.size());
+
+		// the batch gives what one propagator gives set by set, and both what the naive sweep gives
+		UnitPropagator propagator(store);
+		propagator.propagate();
+		AssumptionResult result;
+		std::size_t conflicts = 0;
+
+		for(std::size_t i = 0; i < sets.size(); ++i)
+		{
+			AssumptionResult expected = naive_propagation(clauses, numvar, sets[i]);
+			EXPECT_EQ(expected.conflict, single[i].conflict) << "round " << round << ", set " << i;
+			if(!expected.conflict)
+				EXPECT_EQ(expected.implied, sorted(single[i].implied)) << "round " << round << ", set " << i;
+			conflicts += expected.conflict;
+
+			propagator.propagate_assumptions(sets[i], result);
+			EXPECT_EQ(result.conflict, single[i].conflict) << "round " << round << ", set " << i;
+			EXPECT_EQ(result.implied, single[i].implied) << "round " << round << ", set " << i;
+			EXPECT_EQ(single[i].conflict, parallel[i].conflict) << "round " << round << ", set " << i;
+			EXPECT_EQ(single[i].implied, parallel[i].implied) << "round " << round << ", set " << i;
+		}
+
+		// both outcomes are covered
+		EXPECT_LT(0u, conflicts) << "round " << round;
+		EXPECT_GT(sets.size(), conflicts) << "round " << round;
+	}
+}